@@ -0,0 +1,123 @@
+#ifndef ATTACKS_HPP
+#define ATTACKS_HPP
+
+#include "bitboard.hpp"
+#include "chess_piece.hpp"
+#include <array>
+
+/*
+ * Precomputed attack tables.
+ *
+ * Leaper attacks (knight, king, pawn) are plain per-square lookups.
+ * Sliding attacks use per-direction rays: the ray from a square is cut at
+ * the first blocker, found with lsb() for rays running towards higher
+ * square numbers and msb() for rays running towards lower ones.
+ *
+ * All tables are built at compile time, so there is no init order to
+ * worry about.
+ */
+
+namespace attack_tables {
+
+using Table = std::array<Bitboard, 64>;
+
+// Ray directions. The first four run towards higher square numbers.
+enum Direction { East, SouthEast, South, SouthWest, West, NorthWest, North, NorthEast };
+
+constexpr int kDirX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+constexpr int kDirY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+constexpr bool onBoard(int x, int y) {
+    return x >= 0 && x < 8 && y >= 0 && y < 8;
+}
+
+constexpr Table buildSteps(const int (&dx)[8], const int (&dy)[8]) {
+    Table table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int i = 0; i < 8; ++i) {
+            int x = squareX(sq) + dx[i];
+            int y = squareY(sq) + dy[i];
+            if (onBoard(x, y))
+                table[sq] |= squareBB(makeSquare(x, y));
+        }
+    }
+    return table;
+}
+
+constexpr int kKnightX[8] = { 1, 2, 2, 1, -1, -2, -2, -1 };
+constexpr int kKnightY[8] = { 2, 1, -1, -2, -2, -1, 1, 2 };
+
+// Pawns attack one row forward: white towards y = 0, black towards y = 7
+constexpr Table buildPawn(int dir) {
+    Table table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        int y = squareY(sq) + dir;
+        for (int dx : { -1, 1 }) {
+            int x = squareX(sq) + dx;
+            if (onBoard(x, y))
+                table[sq] |= squareBB(makeSquare(x, y));
+        }
+    }
+    return table;
+}
+
+constexpr std::array<Table, 8> buildRays() {
+    std::array<Table, 8> rays{};
+    for (int d = 0; d < 8; ++d) {
+        for (int sq = 0; sq < 64; ++sq) {
+            int x = squareX(sq) + kDirX[d];
+            int y = squareY(sq) + kDirY[d];
+            while (onBoard(x, y)) {
+                rays[d][sq] |= squareBB(makeSquare(x, y));
+                x += kDirX[d];
+                y += kDirY[d];
+            }
+        }
+    }
+    return rays;
+}
+
+inline constexpr Table kKnight = buildSteps(kKnightX, kKnightY);
+inline constexpr Table kKing   = buildSteps(kDirX, kDirY);
+inline constexpr std::array<Table, 2> kPawn = { buildPawn(-1), buildPawn(+1) };
+inline constexpr std::array<Table, 8> kRays = buildRays();
+
+inline Bitboard rayAttacks(int dir, int sq, Bitboard occupied) {
+    Bitboard attacks = kRays[dir][sq];
+    Bitboard blockers = attacks & occupied;
+    if (blockers) {
+        int first = (dir < West) ? lsb(blockers) : msb(blockers);
+        attacks ^= kRays[dir][first];
+    }
+    return attacks;
+}
+
+} // namespace attack_tables
+
+/* ---- Lookups ---- */
+
+inline Bitboard knightAttacks(int sq) { return attack_tables::kKnight[sq]; }
+inline Bitboard kingAttacks(int sq) { return attack_tables::kKing[sq]; }
+
+// Squares a pawn of the given color standing on sq attacks
+inline Bitboard pawnAttacks(Color color, int sq) {
+    return attack_tables::kPawn[colorIndex(color)][sq];
+}
+
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    using namespace attack_tables;
+    return rayAttacks(East, sq, occupied) | rayAttacks(South, sq, occupied) |
+           rayAttacks(West, sq, occupied) | rayAttacks(North, sq, occupied);
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    using namespace attack_tables;
+    return rayAttacks(SouthEast, sq, occupied) | rayAttacks(SouthWest, sq, occupied) |
+           rayAttacks(NorthWest, sq, occupied) | rayAttacks(NorthEast, sq, occupied);
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+#endif
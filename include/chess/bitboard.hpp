@@ -0,0 +1,36 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstdint>
+
+/*
+ * A bitboard is a 64-bit set of squares.
+ *
+ * Squares are numbered to match the board's (x, y) coordinates:
+ *   square = y * 8 + x
+ * so bit 0 is A8, bit 7 is H8, bit 56 is A1 and bit 63 is H1.
+ */
+using Bitboard = std::uint64_t;
+
+constexpr int makeSquare(int x, int y) { return y * 8 + x; }
+constexpr int squareX(int sq) { return sq & 7; }
+constexpr int squareY(int sq) { return sq >> 3; }
+
+constexpr Bitboard squareBB(int sq) { return Bitboard(1) << sq; }
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+
+// Index of the lowest set bit (b must not be empty)
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+
+// Index of the highest set bit (b must not be empty)
+inline int msb(Bitboard b) { return 63 - __builtin_clzll(b); }
+
+// Remove and return the lowest set bit (b must not be empty)
+inline int popLsb(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+#endif
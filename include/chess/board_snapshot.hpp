@@ -0,0 +1,74 @@
+#ifndef BOARD_SNAPSHOT_HPP
+#define BOARD_SNAPSHOT_HPP
+
+#include "bitboard.hpp"
+#include "chess_piece.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/* ---------------- BoardSnapshot ---------------- */
+
+/*
+ * The position part of a ChessBoard as plain data: no undo history, no
+ * mailbox, just the bitboards and the state around them (80 bytes).
+ * ChessBoard::snapshot() fills one with a few fixed-size copies and
+ * ChessBoard::restore() turns one back into a playable board.
+ */
+struct BoardSnapshot {
+    std::array<Bitboard, 6> pieces;  // by PieceType
+    std::array<Bitboard, 2> colors;  // by Color
+    std::uint64_t hash;
+    std::uint8_t castlingRights;
+    std::int8_t enPassantSquare;     // -1 if none
+    std::uint8_t sideToMove;         // colorIndex()
+    std::uint8_t reserved[5];
+
+    // Piece on a square (Piece() if empty)
+    Piece pieceAt(int x, int y) const;
+    Color side() const { return static_cast<Color>(sideToMove); }
+};
+
+static_assert(std::is_trivial<BoardSnapshot>::value &&
+              std::is_standard_layout<BoardSnapshot>::value,
+              "BoardSnapshot must stay plain data");
+static_assert(sizeof(BoardSnapshot) % sizeof(std::uint64_t) == 0,
+              "BoardSnapshot is published in whole 64-bit words");
+
+/* ---------------- SnapshotPublisher ---------------- */
+
+/*
+ * Hands the latest snapshot of a game from its one writer to any number of
+ * reader threads, without locks (a seqlock).
+ *
+ * publish() bumps the sequence to odd, rewrites the words and bumps it to
+ * even again, so the writer never waits for anyone. read() copies the
+ * words out and retries if the sequence was odd or changed meanwhile, so
+ * it always returns one whole published snapshot, never a mix of two.
+ * The words are atomics, so a racing copy is not a data race.
+ */
+class SnapshotPublisher {
+public:
+    SnapshotPublisher();
+
+    // Only one thread may publish (the thread that owns the game)
+    void publish(const BoardSnapshot& snapshot);
+
+    // Any thread; never blocks the writer
+    BoardSnapshot read() const;
+
+    // Number of snapshots published so far
+    std::uint64_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr std::size_t kWords =
+        sizeof(BoardSnapshot) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence_{ 0 };
+    std::array<std::atomic<std::uint64_t>, kWords> words_;
+};
+
+#endif
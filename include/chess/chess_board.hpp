@@ -2,44 +2,192 @@
 #define CHESS_BOARD_HPP
 
 #include "chess_piece.hpp"
-#include <memory>
+#include "board_snapshot.hpp"
+#include "bitboard.hpp"
+#include "move.hpp"
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
+
+// Castling rights bits
+enum CastlingRight : std::uint8_t {
+    WhiteKingSide  = 1, // H1 rook
+    WhiteQueenSide = 2, // A1 rook
+    BlackKingSide  = 4, // H8 rook
+    BlackQueenSide = 8, // A8 rook
+    AllCastling    = 15
+};
+
+// Outcome of the position for the side to move
+enum class GameStatus { Ongoing, Checkmate, Stalemate };
 
 class ChessBoard {
+public:
+    // Deepest line makeMove() can go before unmakeMove() is needed
+    static constexpr int kMaxPly = 256;
+
 private:
-    // Castling state
-    bool whiteKingMoved_  = false;
-    bool blackKingMoved_  = false;
+    // Castling state: rights still available (CastlingRight bits)
+    std::uint8_t castlingRights_ = AllCastling;
+
+    // Square a pawn just skipped with a double step, or -1
+    int enPassantSquare_ = -1;
+
+    Color sideToMove_ = Color::White;
+
+    // Zobrist key of the position, maintained incrementally
+    std::uint64_t hash_ = 0;
+
+    // Plies since the last capture or pawn move, and the move number
+    std::uint16_t halfmoveClock_ = 0;
+    std::uint16_t fullmoveNumber_ = 1;
 
-    bool whiteRookAMoved_ = false; // A1 rook
-    bool whiteRookHMoved_ = false; // H1 rook
-    bool blackRookAMoved_ = false; // A8 rook
-    bool blackRookHMoved_ = false; // H8 rook
+    // Everything makeMove() destroys, so unmakeMove() can put it back
+    struct UndoInfo {
+        std::uint64_t hash;
+        Move move;
+        std::int8_t captured;      // PieceType index, or -1
+        std::uint8_t castlingRights;
+        std::int8_t enPassantSquare;
+        std::uint16_t halfmoveClock;
+        std::uint16_t fullmoveNumber;
+    };
 
-    bool isPathClear(int fromX, int fromY, int toX, int toY) const;
+    std::array<UndoInfo, kMaxPly> undo_;
+    int ply_ = 0;
 
-    struct EnPassantInfo {
-        bool valid = false;
-        int x = -1;
-        int y = -1;
-    } enPassant_;
+    // Keys of the game's positions before the current one, oldest first,
+    // back to the last capture or pawn move: earlier ones cannot recur.
+    // Past kMaxHistory (the fifty-move rule's 100 plies) the oldest go.
+    static constexpr int kMaxHistory = 100;
+    std::array<std::uint64_t, kMaxHistory> history_;
+    int historyCount_ = 0;
 
 private:
-    std::array<std::array<std::unique_ptr<Piece>, 8>, 8> board_;
+    // Bitboard position: one occupancy mask per piece type and per color.
+    // Indexed by static_cast<int>(PieceType) / static_cast<int>(Color).
+    std::array<Bitboard, 6> pieces_{};
+    std::array<Bitboard, 2> colors_{};
+
+    // Mailbox mirror of the bitboards: what stands on each square
+    std::array<Piece, 64> squares_{};
+
+    // King squares are cached so check detection never has to search for them
+    std::array<int, 2> kingSquare_ = { -1, -1 };
+
+    Bitboard occupied() const { return colors_[0] | colors_[1]; }
+
+    bool pieceAt(int sq, Color& color, PieceType& type) const;
+    void putPiece(int sq, Color color, PieceType type);
+    void removePiece(int sq, Color color, PieceType type);
+    void shiftPiece(int from, int to, Color color, PieceType type);
+    bool isAttacked(int sq, Color byColor, Bitboard occ, Bitboard ignore) const;
+
+    // Move generation (move_generator.cpp)
+    void generatePseudoMoves(Color color, Bitboard fromMask, MoveList& moves) const;
+    void generateCastling(Color color, MoveList& moves) const;
+    void generateLegalMoves(Color color, Bitboard fromMask, MoveList& moves) const;
+    bool isLegal(Move move, Color color) const;
 
 public:
     ChessBoard();
     void initialize();
-    bool movePiece(int fx, int fy, int tx, int ty);
+    bool movePiece(int fx, int fy, int tx, int ty,
+                   PieceType promotion = PieceType::Queen);
+
+    // The legal move movePiece() would play, or a null Move
+    Move findMove(int fx, int fy, int tx, int ty,
+                  PieceType promotion = PieceType::Queen) const;
+
+    // Plays a move from findMove() as a game move (it cannot be taken back)
+    void playMove(Move move);
     bool isKingInCheck(Color kingColor) const;
-    bool isCheckmate(Color color);
-    const Piece* getPiece(int x, int y) const {
-        return board_[y][x].get();
+    bool isSquareAttacked(int x, int y, Color byColor) const;
+    bool isCheckmate(Color color) const;
+    bool isStalemate(Color color) const;
+    GameStatus status() const; // for the side to move
+
+    // Piece on a square, or nullptr if it is empty. The pointer is into
+    // this board and shows whatever stands on the square later on.
+    const Piece* getPiece(int x, int y) const;
+
+    // Side that moves next (flips after every successful move)
+    Color sideToMove() const { return sideToMove_; }
+
+    // 64-bit Zobrist key: pieces, side to move, castling rights and
+    // en-passant file. Equal positions have equal keys.
+    std::uint64_t hash() const { return hash_; }
+
+    // Same key rebuilt from scratch (for checking the incremental one)
+    std::uint64_t computeHash() const;
+
+    // True if the current position already occurred, earlier in the
+    // makeMove() line or in the game played before it with playMove()
+    bool isRepetition() const;
+
+    // Bitboard of one color's pieces of one type
+    Bitboard pieces(Color color, PieceType type) const {
+        return pieces_[typeIndex(type)] & colors_[colorIndex(color)];
     }
 
+    // All legal moves for the side to move
+    void generateLegalMoves(MoveList& moves) const;
+
+    // Plays a move produced by generateLegalMoves() without re-validating it.
+    // Allocation-free; every makeMove() must be paired with an unmakeMove().
+    void makeMove(Move move);
+    void unmakeMove();
+
+    // Number of moves that can currently be taken back with unmakeMove()
+    int ply() const { return ply_; }
+
+    // The current position as plain data, for other threads to read
+    BoardSnapshot snapshot() const;
+
+    // Sets up the position from a snapshot (with no moves to take back)
+    void restore(const BoardSnapshot& snapshot);
+
+    // Forsyth-Edwards Notation, all six fields (fen.cpp). Neither call
+    // allocates. fromFEN() returns false, leaving the board as it was, if
+    // the text does not parse or no game could continue from it. The
+    // counters may be left out and default to "0 1".
+    bool fromFEN(std::string_view fen);
+
+    // toFEN() output is at most this long, terminating NUL included
+    static constexpr std::size_t kMaxFEN = 96;
+
+    // Writes the FEN and a NUL to `out`; returns the length without it.
+    // The en-passant square is only given when a pawn can take there.
+    std::size_t toFEN(char* out) const;
+
+    // Plies since the last capture or pawn move (the fifty-move rule)
+    int halfmoveClock() const { return halfmoveClock_; }
+
+    // Starts at 1 and goes up after each Black move
+    int fullmoveNumber() const { return fullmoveNumber_; }
+
+    // Standard Algebraic Notation (san.cpp), e.g. "Nbd7", "exd6", "O-O",
+    // "e8=Q+". fromSAN() returns the legal move meant, or a null Move if
+    // no move or more than one fits. Check marks and "!?" annotations are
+    // not checked. Neither call allocates.
+    Move fromSAN(std::string_view san) const;
+
+    // toSAN() output is at most this long, terminating NUL included
+    static constexpr std::size_t kMaxSAN = 8;
+
+    // Writes the SAN of a legal move and a NUL to `out`; returns the
+    // length without it
+    std::size_t toSAN(Move move, char* out) const;
 
     std::string display() const;
 };
 
+// Boards are copied freely (searches, snapshots, thousands of games), so
+// copying one must stay a plain memcpy
+static_assert(std::is_trivially_copyable<ChessBoard>::value,
+              "ChessBoard must be trivially copyable");
+
 #endif
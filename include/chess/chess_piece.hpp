@@ -1,65 +1,50 @@
 #ifndef CHESS_PIECE_HPP
 #define CHESS_PIECE_HPP
 
-#include <string>
-#include <cmath>
+#include <cstdint>
 
 enum class Color { White, Black };
 enum class PieceType { Pawn, Rook, Knight, Bishop, Queen, King };
 
-class Piece {
+inline constexpr Color opposite(Color c) {
+    return c == Color::White ? Color::Black : Color::White;
+}
 
-protected:
-    Color color_;
-    PieceType type_;
+// Array indices for per-color / per-type tables
+inline constexpr int colorIndex(Color c) { return static_cast<int>(c); }
+inline constexpr int typeIndex(PieceType t) { return static_cast<int>(t); }
 
+/*
+ * A piece as a one-byte value: 0 is an empty square, otherwise bits 0-2
+ * hold the PieceType + 1 and bit 3 the color. Move shapes are checked
+ * with a switch on the type, so there is no vtable and nothing to allocate,
+ * and anything holding pieces can be copied with memcpy.
+ */
+class Piece {
 public:
-    Piece(Color color, PieceType type) : color_(color), type_(type) {}
-    virtual ~Piece() = default;
-
-    Color getColor() const { return color_; }
-    PieceType getType() const { return type_; }
-
-    virtual bool isValidMove(int fx, int fy, int tx, int ty) const = 0;
+    constexpr Piece() = default;
+    constexpr Piece(Color color, PieceType type)
+        : code_(static_cast<std::uint8_t>(
+              (typeIndex(type) + 1) | (colorIndex(color) << 3))) {}
+
+    constexpr bool isEmpty() const { return code_ == 0; }
+    constexpr Color getColor() const { return static_cast<Color>(code_ >> 3); }
+    constexpr PieceType getType() const {
+        return static_cast<PieceType>((code_ & 7) - 1);
+    }
+
+    // Shape of the move only; the board checks paths, captures and checks
+    bool isValidMove(int fx, int fy, int tx, int ty) const;
     char symbol() const;
-};
-
-/* ---- Pieces ---- */
-
-class Pawn : public Piece {
-public:
-    Pawn(Color c) : Piece(c, PieceType::Pawn) {}
-    bool isValidMove(int fx, int fy, int tx, int ty) const override;
-};
-
-class Rook : public Piece {
-public:
-    Rook(Color c) : Piece(c, PieceType::Rook) {}
-    bool isValidMove(int fx, int fy, int tx, int ty) const override;
-};
-
-class Knight : public Piece {
-public:
-    Knight(Color c) : Piece(c, PieceType::Knight) {}
-    bool isValidMove(int fx, int fy, int tx, int ty) const override;
-};
 
-class Bishop : public Piece {
-public:
-    Bishop(Color c) : Piece(c, PieceType::Bishop) {}
-    bool isValidMove(int fx, int fy, int tx, int ty) const override;
-};
+    constexpr std::uint8_t raw() const { return code_; }
+    constexpr bool operator==(Piece other) const { return code_ == other.code_; }
+    constexpr bool operator!=(Piece other) const { return code_ != other.code_; }
 
-class Queen : public Piece {
-public:
-    Queen(Color c) : Piece(c, PieceType::Queen) {}
-    bool isValidMove(int fx, int fy, int tx, int ty) const override;
+private:
+    std::uint8_t code_ = 0;
 };
 
-class King : public Piece {
-public:
-    King(Color c) : Piece(c, PieceType::King) {}
-    bool isValidMove(int fx, int fy, int tx, int ty) const override;
-};
+static_assert(sizeof(Piece) == 1, "Piece must stay one byte");
 
 #endif
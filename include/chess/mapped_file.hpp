@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/* ---------------- MappedFile ---------------- */
+
+/*
+ * A whole file mapped read-only into memory, for as long as the object
+ * lives. The kernel pages it in as it is touched, so a file of any size
+ * costs no heap. `access` tells the kernel how it will be read: front to
+ * back (read ahead, drop pages behind) or here and there.
+ */
+class MappedFile {
+public:
+    enum class Access { Sequential, Random };
+
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::string_view text() const { return { data_, size_ }; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef MOVE_HPP
+#define MOVE_HPP
+
+#include "chess_piece.hpp"
+#include "bitboard.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * Move packs a move into 16 bits:
+ *   bits  0-5   from square
+ *   bits  6-11  to square
+ *   bits 12-15  flag (see Move::Flag)
+ * Squares use the bitboard numbering (square = y * 8 + x).
+ * The all-zero value (A8 -> A8) is never a legal move and means "no move".
+ */
+class Move {
+public:
+    enum Flag : std::uint16_t {
+        Normal      = 0,
+        DoublePush  = 1,
+        Castle      = 2,
+        EnPassant   = 3,
+        PromoKnight = 4,
+        PromoBishop = 5,
+        PromoRook   = 6,
+        PromoQueen  = 7
+    };
+
+    Move() : data_(0) {}
+    Move(int from, int to, Flag flag = Normal)
+        : data_(static_cast<std::uint16_t>(from | (to << 6) | (flag << 12))) {}
+
+    int from() const { return data_ & 0x3F; }
+    int to() const { return (data_ >> 6) & 0x3F; }
+    Flag flag() const { return static_cast<Flag>(data_ >> 12); }
+
+    bool isNull() const { return data_ == 0; }
+    bool isPromotion() const { return flag() >= PromoKnight; }
+
+    // Only meaningful when isPromotion()
+    PieceType promotion() const {
+        switch (flag()) {
+            case PromoKnight: return PieceType::Knight;
+            case PromoBishop: return PieceType::Bishop;
+            case PromoRook:   return PieceType::Rook;
+            default:          return PieceType::Queen;
+        }
+    }
+
+    static Flag promotionFlag(PieceType type) {
+        switch (type) {
+            case PieceType::Knight: return PromoKnight;
+            case PieceType::Bishop: return PromoBishop;
+            case PieceType::Rook:   return PromoRook;
+            default:                return PromoQueen;
+        }
+    }
+
+    std::uint16_t raw() const { return data_; }
+    static Move fromRaw(std::uint16_t raw) {
+        Move m;
+        m.data_ = raw;
+        return m;
+    }
+
+    // Coordinate notation, e.g. "e2e4" or "e7e8q"
+    std::string toString() const {
+        std::string s;
+        s += static_cast<char>('a' + squareX(from()));
+        s += static_cast<char>('8' - squareY(from()));
+        s += static_cast<char>('a' + squareX(to()));
+        s += static_cast<char>('8' - squareY(to()));
+        if (isPromotion())
+            s += "nbrq"[flag() - PromoKnight];
+        return s;
+    }
+
+    // Parses coordinate notation. Text cannot tell castling, en passant or
+    // double pushes apart, so only promotion flags are set; match the
+    // squares against generated moves to get the real move. Null if malformed.
+    static Move fromString(std::string_view text) {
+        if (text.size() != 4 && text.size() != 5)
+            return Move();
+
+        int fx = text[0] - 'a', fy = '8' - text[1];
+        int tx = text[2] - 'a', ty = '8' - text[3];
+        for (int v : { fx, fy, tx, ty })
+            if (v < 0 || v > 7)
+                return Move();
+
+        Flag flag = Normal;
+        if (text.size() == 5) {
+            switch (text[4]) {
+                case 'n': flag = PromoKnight; break;
+                case 'b': flag = PromoBishop; break;
+                case 'r': flag = PromoRook;   break;
+                case 'q': flag = PromoQueen;  break;
+                default:  return Move();
+            }
+        }
+        return Move(makeSquare(fx, fy), makeSquare(tx, ty), flag);
+    }
+
+    bool operator==(const Move& other) const { return data_ == other.data_; }
+    bool operator!=(const Move& other) const { return data_ != other.data_; }
+
+private:
+    std::uint16_t data_;
+};
+
+/*
+ * Fixed-capacity move list meant to live on the stack.
+ * 256 is above the largest known number of legal moves (218).
+ */
+class MoveList {
+public:
+    static constexpr std::size_t kCapacity = 256;
+
+    void push_back(Move move) { moves_[size_++] = move; }
+    void clear() { size_ = 0; }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    Move& operator[](std::size_t i) { return moves_[i]; }
+    const Move& operator[](std::size_t i) const { return moves_[i]; }
+
+    Move* begin() { return moves_.data(); }
+    Move* end() { return moves_.data() + size_; }
+    const Move* begin() const { return moves_.data(); }
+    const Move* end() const { return moves_.data() + size_; }
+
+private:
+    std::array<Move, kCapacity> moves_;
+    std::size_t size_ = 0;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef MOVE_UPDATE_HPP
+#define MOVE_UPDATE_HPP
+
+#include "chess_board.hpp"
+#include "packed_position.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * Text protocol lines that keep a client's own board in step with the
+ * server's without resending the board:
+ *
+ *   MOVED e2e4 BLACK ONGOING 8f3a0c9e1b2d4f60
+ *     a move was played: the move, side to move, GameStatus and the
+ *     Zobrist key of the new position (16 hex digits)
+ *
+ *   POSITION <48 hex digits>
+ *     the whole position as a PackedPosition, sent when the client asks
+ *     with BOARD (after a key mismatch, or at any time)
+ *
+ * A client plays each MOVED on its board and compares keys; a mismatch
+ * means the copies diverged and it asks for a POSITION.
+ */
+struct MoveUpdate {
+    Move move; // squares and promotion only (see Move::fromString)
+    Color sideToMove = Color::White;
+    GameStatus status = GameStatus::Ongoing;
+    std::uint64_t hash = 0;
+};
+
+std::string formatMoveUpdate(const MoveUpdate& update);
+bool parseMoveUpdate(std::string_view line, MoveUpdate& update);
+
+std::string formatPosition(const PackedPosition& packed);
+bool parsePosition(std::string_view line, PackedPosition& packed);
+
+// Plays an update on a mirror board. False if the move is not legal there
+// or the resulting key differs: the mirror needs a resync.
+bool applyMoveUpdate(ChessBoard& board, const MoveUpdate& update);
+
+#endif
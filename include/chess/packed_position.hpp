@@ -0,0 +1,34 @@
+#ifndef PACKED_POSITION_HPP
+#define PACKED_POSITION_HPP
+
+#include "board_snapshot.hpp"
+#include <array>
+#include <cstdint>
+
+/* ---------------- PackedPosition ---------------- */
+
+/*
+ * A whole position in 24 bytes, for the wire:
+ *
+ *   bytes 0-7   occupancy bitboard, least significant byte first
+ *   bytes 8-23  one 4-bit code per occupied square, in square order,
+ *               low nibble first (a legal position has at most 32 pieces)
+ *
+ * Codes 0-5 are the white Pawn, Rook, Knight, Bishop, Queen, King (the
+ * PieceType order) and 6-11 the same for black. Three more codes carry
+ * the rest of the state; their color follows from the square:
+ *
+ *   12  a pawn that can be taken en passant
+ *   13  a rook that can still castle
+ *   14  the black king, with black to move
+ */
+struct PackedPosition {
+    std::array<std::uint8_t, 24> bytes{};
+};
+
+PackedPosition packPosition(const BoardSnapshot& snapshot);
+
+// False if the bytes do not describe a position this encoding can produce
+bool unpackPosition(const PackedPosition& packed, BoardSnapshot& snapshot);
+
+#endif
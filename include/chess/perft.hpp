@@ -0,0 +1,15 @@
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include "chess_board.hpp"
+#include <cstdint>
+
+/*
+ * Perft: counts the leaf nodes of the legal move tree to a fixed depth.
+ * The totals are well known for standard positions, which makes this the
+ * reference check for move generation correctness and speed.
+ */
+// Walks the tree with makeMove()/unmakeMove(); the board is left unchanged.
+std::uint64_t perft(ChessBoard& board, int depth);
+
+#endif
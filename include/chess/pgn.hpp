@@ -0,0 +1,122 @@
+#ifndef PGN_HPP
+#define PGN_HPP
+
+#include "chess_board.hpp"
+#include "mapped_file.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* ---------------- PgnGame ---------------- */
+
+// A tag pair such as [White "Morphy, Paul"]. The value is as written:
+// escaped quotes and backslashes are left in.
+struct PgnTag {
+    std::string_view name;
+    std::string_view value;
+};
+
+/*
+ * One game of a PGN file, as views into the file's text. Nothing is
+ * copied, so a game is good only as long as the reader that produced it.
+ * Tags past kMaxTags are skipped.
+ */
+struct PgnGame {
+    static constexpr std::size_t kMaxTags = 32;
+
+    std::string_view text;      // the whole game, tags and moves
+    std::string_view movetext;  // the moves, comments and result
+    std::array<PgnTag, kMaxTags> tags{};
+    std::size_t tagCount = 0;
+
+    // Value of the named tag, or empty if the game has none
+    std::string_view tag(std::string_view name) const;
+};
+
+/* ---------------- PgnMoves ---------------- */
+
+/*
+ * The moves of a movetext one SAN token at a time, skipping move numbers,
+ * comments, variations and NAGs. Stops at the game termination marker
+ * ("1-0", "0-1", "1/2-1/2" or "*"), which result() then gives.
+ */
+class PgnMoves {
+public:
+    explicit PgnMoves(std::string_view movetext)
+        : at_(movetext.data()), end_(movetext.data() + movetext.size()) {}
+
+    // The next move as written, e.g. "Nxe5+"; false when there are no more
+    bool next(std::string_view& san);
+
+    // The termination marker, or empty if the moves ran out without one
+    std::string_view result() const { return result_; }
+
+private:
+    const char* at_;
+    const char* end_;
+    std::string_view result_;
+};
+
+/* ---------------- Replay ---------------- */
+
+struct PgnReplay {
+    int plies = 0;              // moves played
+    std::string_view failed;    // what could not be played; empty if all was
+    std::string_view result;    // the termination marker
+
+    bool ok() const { return failed.empty(); }
+};
+
+// Sets `board` up from the game's FEN tag, or the initial position, and
+// plays the moves on it, stopping at the first move that does not parse
+// or is not legal (or at the FEN itself, if that does not parse)
+PgnReplay replayGame(const PgnGame& game, ChessBoard& board);
+
+/* ---------------- PgnReader ---------------- */
+
+/*
+ * Reads the games of a PGN file in order. The file is memory-mapped, not
+ * read (see MappedFile), and games are handed out as views into the
+ * mapping.
+ *
+ * A game starts at a line beginning with '[' and runs to the next such
+ * line, as the PGN export format lays games out. Lines beginning with
+ * '%' between games are skipped.
+ */
+class PgnReader {
+public:
+    // Maps `path`. Throws std::runtime_error if it cannot be opened.
+    explicit PgnReader(const std::string& path);
+
+    // Reads text already in memory, which must outlive the reader
+    explicit PgnReader(std::string_view text);
+
+    ~PgnReader();
+
+    PgnReader(const PgnReader&) = delete;
+    PgnReader& operator=(const PgnReader&) = delete;
+
+    // The next game; false at the end of the file. `game` is overwritten,
+    // so one PgnGame can be reused for a whole file.
+    bool next(PgnGame& game);
+
+    std::size_t size() const { return size_; }
+
+    // The whole file, e.g. to cut up with splitGames()
+    std::string_view text() const { return { data_, size_ }; }
+
+private:
+    std::unique_ptr<MappedFile> file_; // none when reading from memory
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t at_ = 0;
+};
+
+// Cuts PGN text into at most `parts` pieces of about equal size, each
+// made of whole games, so several readers can go through one file
+std::vector<std::string_view> splitGames(std::string_view text, std::size_t parts);
+
+#endif
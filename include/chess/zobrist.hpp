@@ -0,0 +1,64 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include "chess_piece.hpp"
+#include <array>
+#include <cstdint>
+
+/*
+ * Zobrist keys: one random 64-bit number per (color, piece type, square),
+ * per castling-rights combination, per en-passant file and for "black to
+ * move". A position's key is the XOR of the numbers for everything in it,
+ * so a move only has to XOR out what changed and XOR in what appeared.
+ *
+ * The numbers come from a fixed-seed splitmix64 generator evaluated at
+ * compile time, so keys are identical across runs and processes.
+ */
+namespace zobrist {
+
+constexpr std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct Keys {
+    std::uint64_t pieces[2][6][64] = {};
+    std::uint64_t castling[16] = {};
+    std::uint64_t enPassantFile[8] = {};
+    std::uint64_t blackToMove = 0;
+};
+
+constexpr Keys buildKeys() {
+    Keys keys{};
+    std::uint64_t state = 0x43686573737921ULL; // "Chessy!"
+
+    for (auto& color : keys.pieces)
+        for (auto& type : color)
+            for (auto& sq : type)
+                sq = splitmix64(state);
+    for (auto& k : keys.castling)
+        k = splitmix64(state);
+    for (auto& k : keys.enPassantFile)
+        k = splitmix64(state);
+    keys.blackToMove = splitmix64(state);
+
+    // No rights is the common case late in a game; keep it neutral
+    keys.castling[0] = 0;
+    return keys;
+}
+
+inline constexpr Keys kKeys = buildKeys();
+
+inline std::uint64_t piece(Color color, PieceType type, int sq) {
+    return kKeys.pieces[colorIndex(color)][typeIndex(type)][sq];
+}
+
+inline std::uint64_t castling(int rights) { return kKeys.castling[rights]; }
+inline std::uint64_t enPassant(int file) { return kKeys.enPassantFile[file]; }
+inline std::uint64_t blackToMove() { return kKeys.blackToMove; }
+
+} // namespace zobrist
+
+#endif
@@ -1,7 +1,22 @@
 #include "client_network.hpp"
 
+#include <cstdio>
 #include <iostream>
 
+#include "chess/move_update.hpp"
+
+namespace {
+
+// 183500 -> "3:03.5"
+std::string formatClock(long millis) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%ld:%02ld.%ld",
+                  millis / 60000, millis / 1000 % 60, millis / 100 % 10);
+    return text;
+}
+
+} // namespace
+
 /* ---------------- Constructor ---------------- */
 
 ClientNetwork::ClientNetwork(boost::asio::io_context& io_context,
@@ -9,8 +24,13 @@ ClientNetwork::ClientNetwork(boost::asio::io_context& io_context,
                              short port)
     : resolver_(io_context),
       socket_(io_context),
+      keepAliveTimer_(io_context),
       host_(host),
-      port_(port) {}
+      port_(port),
+      buffer_(2048) {
+
+    board_.initialize();
+}
 
 /* ---------------- Start Client ---------------- */
 
@@ -31,16 +51,8 @@ void ClientNetwork::start() {
 void ClientNetwork::handle_connect(const boost::system::error_code& error) {
     if (!error) {
         std::cout << "Connected to server.\n\n";
-
-        auto buffer = std::make_shared<std::vector<char>>(2048);
-
-        socket_.async_read_some(
-            boost::asio::buffer(*buffer),
-            [this, buffer](const boost::system::error_code& ec,
-                           std::size_t bytes) {
-                handle_read(buffer, ec, bytes);
-            }
-        );
+        read();
+        keepAlive();
     }
     else {
         std::cerr << "Connection failed: "
@@ -50,37 +62,105 @@ void ClientNetwork::handle_connect(const boost::system::error_code& error) {
 
 /* ---------------- Read Handler ---------------- */
 
-void ClientNetwork::handle_read(std::shared_ptr<std::vector<char>> buffer,
-                                const boost::system::error_code& error,
+void ClientNetwork::read() {
+    socket_.async_read_some(
+        boost::asio::buffer(buffer_),
+        [this](const boost::system::error_code& ec, std::size_t bytes) {
+            handle_read(ec, bytes);
+        }
+    );
+}
+
+void ClientNetwork::handle_read(const boost::system::error_code& error,
                                 std::size_t bytes_transferred) {
     if (error) {
         std::cerr << "Disconnected from server.\n";
         return;
     }
 
-    std::string message(buffer->begin(),
-                        buffer->begin() + bytes_transferred);
+    pending_.append(buffer_.data(), bytes_transferred);
 
-    std::cout << message << std::endl;
+    // The server speaks in lines; keep any unfinished one for the next read
+    std::size_t start = 0;
+    for (std::size_t end; (end = pending_.find('\n', start)) != std::string::npos;
+         start = end + 1)
+        handle_line(std::string_view(pending_).substr(start, end - start));
+    pending_.erase(0, start);
 
     // Re-arm read for continuous updates
-    auto newBuffer = std::make_shared<std::vector<char>>(2048);
+    read();
+}
 
-    socket_.async_read_some(
-        boost::asio::buffer(*newBuffer),
-        [this, newBuffer](const boost::system::error_code& ec,
-                          std::size_t bytes) {
-            handle_read(newBuffer, ec, bytes);
+void ClientNetwork::handle_line(std::string_view line) {
+    MoveUpdate update;
+    if (parseMoveUpdate(line, update)) {
+        // Play it on our own board; if the keys disagree, ask for the truth
+        if (!applyMoveUpdate(board_, update)) {
+            sendMessage("BOARD\n");
+            return;
         }
-    );
+
+        std::string mover = update.sideToMove == Color::White ? "Black" : "White";
+        std::string toMove = update.sideToMove == Color::White ? "White" : "Black";
+
+        std::cout << mover << " played " << update.move.toString() << "\n";
+        switch (update.status) {
+            case GameStatus::Checkmate:
+                std::cout << "Checkmate! " << mover << " wins.\n";
+                break;
+            case GameStatus::Stalemate:
+                std::cout << "Stalemate! The game is a draw.\n";
+                break;
+            case GameStatus::Ongoing:
+                std::cout << toMove << " to move.\n";
+                break;
+        }
+        std::cout << "\n" << board_.display() << std::endl;
+        return;
+    }
+
+    PackedPosition packed;
+    BoardSnapshot snapshot;
+    if (parsePosition(line, packed) && unpackPosition(packed, snapshot)) {
+        board_.restore(snapshot);
+        std::cout << board_.display() << std::endl;
+        return;
+    }
+
+    // CLOCK <white ms> <black ms>
+    long white = 0, black = 0;
+    if (line.substr(0, 6) == "CLOCK " &&
+        std::sscanf(std::string(line).c_str(), "CLOCK %ld %ld", &white, &black) == 2) {
+        std::cout << "Clock: White " << formatClock(white)
+                  << "  Black " << formatClock(black) << "\n";
+        return;
+    }
+
+    std::cout << line << "\n";
+}
+
+// The server closes connections that stay silent; an empty line is enough
+void ClientNetwork::keepAlive() {
+    keepAliveTimer_.expires_after(std::chrono::seconds(60));
+    keepAliveTimer_.async_wait([this](const boost::system::error_code& error) {
+        if (error)
+            return;
+        sendMessage("\n");
+        keepAlive();
+    });
 }
 
 /* ---------------- Send Message ---------------- */
 
 void ClientNetwork::sendMessage(const std::string& message) {
-    boost::asio::async_write(
-        socket_,
-        boost::asio::buffer(message),
-        [](const boost::system::error_code&, std::size_t) {}
-    );
+    // Own the bytes until the write finishes, and write from the io thread
+    auto data = std::make_shared<std::string>(message);
+
+    boost::asio::post(socket_.get_executor(), [this, data] {
+        boost::asio::async_write(
+            socket_,
+            boost::asio::buffer(*data),
+            [data](const boost::system::error_code&, std::size_t) {}
+        );
+    });
 }
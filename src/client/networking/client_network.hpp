@@ -4,8 +4,11 @@
 #include <boost/asio.hpp>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "chess/chess_board.hpp"
+
 using boost::asio::ip::tcp;
 
 class ClientNetwork {
@@ -19,15 +22,24 @@ public:
 
 private:
     void handle_connect(const boost::system::error_code& error);
-    void handle_read(std::shared_ptr<std::vector<char>> buffer,
-                     const boost::system::error_code& error,
+    void read();
+    void handle_read(const boost::system::error_code& error,
                      std::size_t bytes_transferred);
+    void handle_line(std::string_view line);
+    void keepAlive();
 
 private:
     tcp::resolver resolver_;
     tcp::socket socket_;
+    boost::asio::steady_timer keepAliveTimer_;
     std::string host_;
     short port_;
+
+    std::vector<char> buffer_;
+    std::string pending_;   // received text not yet ended by a newline
+
+    // Our copy of the game, kept in step with MOVED updates
+    ChessBoard board_;
 };
 
 #endif
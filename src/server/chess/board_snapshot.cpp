@@ -0,0 +1,65 @@
+#include "chess/board_snapshot.hpp"
+
+#include <cstring>
+#include <thread>
+
+/* ---------------- BoardSnapshot ---------------- */
+
+Piece BoardSnapshot::pieceAt(int x, int y) const {
+    Bitboard bb = squareBB(makeSquare(x, y));
+    if (!((colors[0] | colors[1]) & bb))
+        return Piece();
+
+    Color color = (colors[colorIndex(Color::White)] & bb) ? Color::White
+                                                          : Color::Black;
+    for (int t = 0; t < 6; ++t)
+        if (pieces[t] & bb)
+            return Piece(color, static_cast<PieceType>(t));
+    return Piece();
+}
+
+/* ---------------- SnapshotPublisher ---------------- */
+
+SnapshotPublisher::SnapshotPublisher() {
+    // Until the first publish, readers see an empty board
+    for (auto& word : words_)
+        word.store(0, std::memory_order_relaxed);
+}
+
+void SnapshotPublisher::publish(const BoardSnapshot& snapshot) {
+    std::uint64_t words[kWords];
+    std::memcpy(words, &snapshot, sizeof(words));
+
+    std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < kWords; ++i)
+        words_[i].store(words[i], std::memory_order_relaxed);
+
+    sequence_.store(seq + 2, std::memory_order_release);
+}
+
+BoardSnapshot SnapshotPublisher::read() const {
+    std::uint64_t words[kWords];
+
+    for (;;) {
+        std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            // A publish is half done; it takes a few stores, so just retry
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (std::size_t i = 0; i < kWords; ++i)
+            words[i] = words_[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    BoardSnapshot snapshot;
+    std::memcpy(&snapshot, words, sizeof(snapshot));
+    return snapshot;
+}
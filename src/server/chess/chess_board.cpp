@@ -1,409 +1,429 @@
 #include "chess/chess_board.hpp"
+#include "chess/attacks.hpp"
+#include "chess/zobrist.hpp"
+#include <algorithm>
+#include <cassert>
 #include <sstream>
 
-ChessBoard::ChessBoard() {
-    for (auto& row : board_)
-        for (auto& cell : row)
-            cell = nullptr;
+namespace {
+
+// Castling rights that survive a move touching each square:
+// moving the king or a rook, or capturing a rook at home, drops them.
+constexpr std::array<std::uint8_t, 64> buildCastlingMasks() {
+    std::array<std::uint8_t, 64> masks{};
+    for (auto& m : masks)
+        m = AllCastling;
+    masks[makeSquare(0, 7)] = AllCastling & ~WhiteQueenSide;
+    masks[makeSquare(7, 7)] = AllCastling & ~WhiteKingSide;
+    masks[makeSquare(4, 7)] = AllCastling & ~(WhiteKingSide | WhiteQueenSide);
+    masks[makeSquare(0, 0)] = AllCastling & ~BlackQueenSide;
+    masks[makeSquare(7, 0)] = AllCastling & ~BlackKingSide;
+    masks[makeSquare(4, 0)] = AllCastling & ~(BlackKingSide | BlackQueenSide);
+    return masks;
 }
 
-void ChessBoard::initialize() {
-    // Black
-    board_[0][0] = std::make_unique<Rook>(Color::Black);
-    board_[0][1] = std::make_unique<Knight>(Color::Black);
-    board_[0][2] = std::make_unique<Bishop>(Color::Black);
-    board_[0][3] = std::make_unique<Queen>(Color::Black);
-    board_[0][4] = std::make_unique<King>(Color::Black);
-    board_[0][5] = std::make_unique<Bishop>(Color::Black);
-    board_[0][6] = std::make_unique<Knight>(Color::Black);
-    board_[0][7] = std::make_unique<Rook>(Color::Black);
-    for (int i = 0; i < 8; ++i)
-        board_[1][i] = std::make_unique<Pawn>(Color::Black);
-
-    // White
-    for (int i = 0; i < 8; ++i)
-        board_[6][i] = std::make_unique<Pawn>(Color::White);
-    board_[7][0] = std::make_unique<Rook>(Color::White);
-    board_[7][1] = std::make_unique<Knight>(Color::White);
-    board_[7][2] = std::make_unique<Bishop>(Color::White);
-    board_[7][3] = std::make_unique<Queen>(Color::White);
-    board_[7][4] = std::make_unique<King>(Color::White);
-    board_[7][5] = std::make_unique<Bishop>(Color::White);
-    board_[7][6] = std::make_unique<Knight>(Color::White);
-    board_[7][7] = std::make_unique<Rook>(Color::White);
+constexpr std::array<std::uint8_t, 64> kCastlingMask = buildCastlingMasks();
+
+// Rook squares for a castling move, from the king's destination
+void castlingRookSquares(int kingTo, int& rookFrom, int& rookTo) {
+    bool kingSide = squareX(kingTo) == 6;
+    int y = squareY(kingTo);
+    rookFrom = makeSquare(kingSide ? 7 : 0, y);
+    rookTo   = makeSquare(kingSide ? 5 : 3, y);
 }
 
-bool ChessBoard::movePiece(int fx, int fy, int tx, int ty) {
-    // Source must have a piece
-    if (!board_[fy][fx])
-        return false;
+} // namespace
 
-    Piece* piece = board_[fy][fx].get();
+ChessBoard::ChessBoard() {
+    pieces_.fill(0);
+    colors_.fill(0);
+    squares_.fill(Piece());
+    hash_ = zobrist::castling(castlingRights_);
+}
 
-    // Save en-passant state (for rollback)
-    bool oldEPValid = enPassant_.valid;
-    int oldEPx = enPassant_.x;
-    int oldEPy = enPassant_.y;
+void ChessBoard::initialize() {
+    pieces_.fill(0);
+    colors_.fill(0);
+    squares_.fill(Piece());
+    kingSquare_ = { -1, -1 };
+
+    castlingRights_ = AllCastling;
+    enPassantSquare_ = -1;
+    sideToMove_ = Color::White;
+    halfmoveClock_ = 0;
+    fullmoveNumber_ = 1;
+    ply_ = 0;
+    historyCount_ = 0;
+    hash_ = zobrist::castling(castlingRights_);
+
+    const PieceType backRank[8] = {
+        PieceType::Rook, PieceType::Knight, PieceType::Bishop, PieceType::Queen,
+        PieceType::King, PieceType::Bishop, PieceType::Knight, PieceType::Rook
+    };
+
+    for (int x = 0; x < 8; ++x) {
+        // Black
+        putPiece(makeSquare(x, 0), Color::Black, backRank[x]);
+        putPiece(makeSquare(x, 1), Color::Black, PieceType::Pawn);
+
+        // White
+        putPiece(makeSquare(x, 6), Color::White, PieceType::Pawn);
+        putPiece(makeSquare(x, 7), Color::White, backRank[x]);
+    }
+}
 
-    // We'll use these for transactional en-passant handling
-    bool willDoEnPassantCapture = false;
-    int epCaptureX = -1, epCaptureY = -1;
-    std::unique_ptr<Piece> epCapturedPawn = nullptr; // holds the captured pawn while committing
+/* ---------------- Bitboard helpers ---------------- */
 
-    // Shape validation
-    if (!piece->isValidMove(fx, fy, tx, ty))
+bool ChessBoard::pieceAt(int sq, Color& color, PieceType& type) const {
+    Piece piece = squares_[sq];
+    if (piece.isEmpty())
         return false;
 
-    /* ===================== CASTLING ===================== */
-    if (piece->getType() == PieceType::King &&
-        std::abs(tx - fx) == 2 &&
-        fy == ty) {
-
-        bool isWhite = (piece->getColor() == Color::White);
-
-        // 1. King cannot be in check
-        if (isKingInCheck(piece->getColor()))
-            return false;
-
-        // 2. King must not have moved
-        if ((isWhite && whiteKingMoved_) ||
-            (!isWhite && blackKingMoved_))
-            return false;
-
-        bool kingSide = (tx > fx);
-        int stepX = kingSide ? fx + 1 : fx - 1;
-        int rookFromX = kingSide ? 7 : 0;
-        int rookToX   = kingSide ? tx - 1 : tx + 1;
-
-        // 3. Rook existence & color
-        if (!board_[fy][rookFromX] ||
-            board_[fy][rookFromX]->getType() != PieceType::Rook ||
-            board_[fy][rookFromX]->getColor() != piece->getColor())
-            return false;
-
-        // 4. Rook must not have moved
-        if (isWhite) {
-            if ((kingSide && whiteRookHMoved_) ||
-                (!kingSide && whiteRookAMoved_))
-                return false;
-        } else {
-            if ((kingSide && blackRookHMoved_) ||
-                (!kingSide && blackRookAMoved_))
-                return false;
-        }
-
-        // 5. Path must be clear: check squares between king and destination (exclude destination)
-        int dir = kingSide ? 1 : -1;
-        for (int x = fx + dir; x != tx; x += dir) {
-            if (board_[fy][x])
-                return false;
-        }
+    color = piece.getColor();
+    type = piece.getType();
+    return true;
+}
 
-        // 6. King cannot pass through check (simulate stepping to the intermediate square)
-        {
-            // Save and simulate king stepping to stepX
-            auto savedKing = std::move(board_[fy][fx]);
-            board_[fy][stepX] = std::move(savedKing);
-            // ensure original is null (already done by move)
-            bool inCheck = isKingInCheck(piece->getColor());
-            // revert
-            board_[fy][fx] = std::move(board_[fy][stepX]);
-            board_[fy][stepX] = nullptr;
-
-            if (inCheck)
-                return false;
-        }
+void ChessBoard::putPiece(int sq, Color color, PieceType type) {
+    pieces_[typeIndex(type)] |= squareBB(sq);
+    colors_[colorIndex(color)] |= squareBB(sq);
+    squares_[sq] = Piece(color, type);
+    hash_ ^= zobrist::piece(color, type, sq);
+    if (type == PieceType::King)
+        kingSquare_[colorIndex(color)] = sq;
+}
 
-        // ---- Perform castling ----
-        board_[ty][tx] = std::move(board_[fy][fx]);
-        board_[fy][fx] = nullptr;
+void ChessBoard::removePiece(int sq, Color color, PieceType type) {
+    pieces_[typeIndex(type)] &= ~squareBB(sq);
+    colors_[colorIndex(color)] &= ~squareBB(sq);
+    squares_[sq] = Piece();
+    hash_ ^= zobrist::piece(color, type, sq);
+    if (type == PieceType::King)
+        kingSquare_[colorIndex(color)] = -1;
+}
 
-        board_[fy][rookToX] = std::move(board_[fy][rookFromX]);
-        board_[fy][rookFromX] = nullptr;
+void ChessBoard::shiftPiece(int from, int to, Color color, PieceType type) {
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    pieces_[typeIndex(type)] ^= fromTo;
+    colors_[colorIndex(color)] ^= fromTo;
+    squares_[to] = squares_[from];
+    squares_[from] = Piece();
+    hash_ ^= zobrist::piece(color, type, from) ^ zobrist::piece(color, type, to);
+    if (type == PieceType::King)
+        kingSquare_[colorIndex(color)] = to;
+}
 
-        // 7. King cannot end in check -> if so revert both king and rook
-        if (isKingInCheck(piece->getColor())) {
-            // revert king
-            board_[fy][fx] = std::move(board_[ty][tx]);
-            board_[ty][tx] = nullptr;
+const Piece* ChessBoard::getPiece(int x, int y) const {
+    const Piece& piece = squares_[makeSquare(x, y)];
+    return piece.isEmpty() ? nullptr : &piece;
+}
 
-            // revert rook
-            board_[fy][rookFromX] = std::move(board_[fy][rookToX]);
-            board_[fy][rookToX] = nullptr;
+/* ---------------- Snapshots ---------------- */
+
+BoardSnapshot ChessBoard::snapshot() const {
+    BoardSnapshot s{};
+    s.pieces = pieces_;
+    s.colors = colors_;
+    s.hash = hash_;
+    s.castlingRights = castlingRights_;
+    s.enPassantSquare = static_cast<std::int8_t>(enPassantSquare_);
+    s.sideToMove = static_cast<std::uint8_t>(colorIndex(sideToMove_));
+    return s;
+}
 
-            // restore en-passant (unchanged here, but keep consistent)
-            enPassant_.valid = oldEPValid;
-            enPassant_.x = oldEPx;
-            enPassant_.y = oldEPy;
+void ChessBoard::restore(const BoardSnapshot& s) {
+    pieces_ = s.pieces;
+    colors_ = s.colors;
+    hash_ = s.hash;
+    castlingRights_ = s.castlingRights;
+    enPassantSquare_ = s.enPassantSquare;
+    sideToMove_ = s.side();
+    halfmoveClock_ = 0;
+    fullmoveNumber_ = 1;
+    ply_ = 0;
+    historyCount_ = 0;
+
+    // Rebuild the mailbox and king squares from the bitboards
+    squares_.fill(Piece());
+    kingSquare_ = { -1, -1 };
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece piece = s.pieceAt(squareX(sq), squareY(sq));
+        squares_[sq] = piece;
+        if (!piece.isEmpty() && piece.getType() == PieceType::King)
+            kingSquare_[colorIndex(piece.getColor())] = sq;
+    }
+}
 
-            return false;
-        }
+/* ---------------- Moves ---------------- */
 
-        // Update flags
-        if (isWhite) {
-            whiteKingMoved_ = true;
-            kingSide ? whiteRookHMoved_ = true : whiteRookAMoved_ = true;
-        } else {
-            blackKingMoved_ = true;
-            kingSide ? blackRookHMoved_ = true : blackRookAMoved_ = true;
-        }
+bool ChessBoard::movePiece(int fx, int fy, int tx, int ty, PieceType promotion) {
+    Move move = findMove(fx, fy, tx, ty, promotion);
+    if (move.isNull())
+        return false;
 
-        // castling clears en-passant
-        enPassant_.valid = false;
-        return true;
-    }
+    playMove(move);
+    return true;
+}
 
-    /* ===================== EN PASSANT (detection only, no mutation) ===================== */
-    // We'll *only* mark intent to perform en-passant here; actual pawn removal happens at commit time
-    if (piece->getType() == PieceType::Pawn) {
-        int dx = tx - fx;
-        int dir = (piece->getColor() == Color::White) ? -1 : +1;
-
-        if (dx != 0) {
-            // capture move: normal capture or en-passant candidate
-            if (!(board_[ty][tx] && board_[ty][tx]->getColor() != piece->getColor())) {
-                // not a normal capture, maybe en-passant
-                if (enPassant_.valid && tx == enPassant_.x && ty == enPassant_.y) {
-                    // mark en-passant capture intent (capture pawn at (fy, tx))
-                    willDoEnPassantCapture = true;
-                    epCaptureX = tx;
-                    epCaptureY = fy; // captured pawn sits on same rank as the capturer before move
-                } else {
-                    return false; // illegal diagonal move
-                }
-            }
-        } else {
-            // forward move must be empty
-            if (board_[ty][tx])
-                return false;
-        }
+Move ChessBoard::findMove(int fx, int fy, int tx, int ty,
+                          PieceType promotion) const {
+    int from = makeSquare(fx, fy);
+    int to   = makeSquare(tx, ty);
+
+    // Source must have a piece; it moves for its own color regardless of turn
+    Color color;
+    PieceType type;
+    if (!pieceAt(from, color, type))
+        return Move();
+
+    // The move generator is the single source of truth for legality
+    MoveList moves;
+    generateLegalMoves(color, squareBB(from), moves);
+
+    for (Move move : moves) {
+        if (move.to() != to)
+            continue;
+        if (move.isPromotion() && move.promotion() != promotion)
+            continue;
+        return move;
     }
 
-    /* ===================== OWN PIECE CAPTURE ===================== */
-    if (board_[ty][tx] &&
-        board_[ty][tx]->getColor() == piece->getColor())
-        return false;
-
-    /* ===================== PATH BLOCKING ===================== */
-    PieceType type = piece->getType();
-    if ((type == PieceType::Rook ||
-         type == PieceType::Bishop ||
-         type == PieceType::Queen) &&
-        !isPathClear(fx, fy, tx, ty))
-        return false;
+    return Move();
+}
 
-    /* ===================== COMMIT MOVE (perform captures transactionally) ===================== */
+void ChessBoard::playMove(Move move) {
+    std::uint64_t before = hash_;
+    makeMove(move);
 
-    // If en-passant capture is intended, stash the pawn now (do not mutate board until stash)
-    if (willDoEnPassantCapture) {
-        // move the captured pawn into epCapturedPawn (so we can restore on rollback)
-        epCapturedPawn = std::move(board_[epCaptureY][epCaptureX]);
-        // board_[epCaptureY][epCaptureX] is now nullptr (captured pawn removed from board)
+    // A played game move is final: keep the undo stack for search lines,
+    // and only the key it left behind, for repetitions
+    ply_ = 0;
+    if (halfmoveClock_ == 0) {
+        historyCount_ = 0;
+        return;
     }
+    if (historyCount_ == kMaxHistory) {
+        std::copy(history_.begin() + 1, history_.end(), history_.begin());
+        --historyCount_;
+    }
+    history_[historyCount_++] = before;
+}
 
-    // Normal capture (destination may be empty)
-    auto captured = std::move(board_[ty][tx]);
-
-    // Move the moving piece
-    board_[ty][tx] = std::move(board_[fy][fx]);
-    board_[fy][fx] = nullptr;
+void ChessBoard::makeMove(Move move) {
+    int from = move.from();
+    int to   = move.to();
+
+    // The mover always stands on `from`
+    Piece moving = squares_[from];
+    Color color = moving.getColor();
+    PieceType type = moving.getType();
+    Color enemy = opposite(color);
+
+    assert(ply_ < kMaxPly && "search line deeper than kMaxPly");
+    UndoInfo& undo = undo_[ply_++];
+    undo.hash = hash_;
+    undo.move = move;
+    undo.captured = -1;
+    undo.castlingRights = castlingRights_;
+    undo.enPassantSquare = static_cast<std::int8_t>(enPassantSquare_);
+    undo.halfmoveClock = halfmoveClock_;
+    undo.fullmoveNumber = fullmoveNumber_;
+
+    /* ---- Captures ---- */
+    Color capturedColor;
+    PieceType capturedType;
+    if (move.flag() == Move::EnPassant) {
+        // captured pawn sits beside the capturer, not on the destination
+        removePiece(makeSquare(squareX(to), squareY(from)), enemy, PieceType::Pawn);
+        undo.captured = static_cast<std::int8_t>(typeIndex(PieceType::Pawn));
+    } else if (pieceAt(to, capturedColor, capturedType)) {
+        removePiece(to, capturedColor, capturedType);
+        undo.captured = static_cast<std::int8_t>(typeIndex(capturedType));
+    }
 
-    // After move commit, if en-passant was performed, the captured pawn has already been removed into epCapturedPawn
-    // (we already moved it above), so nothing further to do here.
+    /* ---- Move the piece ---- */
+    shiftPiece(from, to, color, type);
 
-    /* ===================== POST-MOVE VALIDATION (king safety) ===================== */
+    if (move.isPromotion()) {
+        removePiece(to, color, PieceType::Pawn);
+        putPiece(to, color, move.promotion());
+    }
 
-    // Illegal if own king is in check -> revert everything (including en-passant capture)
-    if (isKingInCheck(piece->getColor())) {
-        // revert moving piece
-        board_[fy][fx] = std::move(board_[ty][tx]);
-        // revert destination
-        board_[ty][tx] = std::move(captured);
+    if (move.flag() == Move::Castle) {
+        int rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        shiftPiece(rookFrom, rookTo, color, PieceType::Rook);
+    }
 
-        // restore ep pawn if it was captured
-        if (epCapturedPawn) {
-            board_[epCaptureY][epCaptureX] = std::move(epCapturedPawn);
+    /* ---- State ---- */
+    hash_ ^= zobrist::castling(castlingRights_);
+    castlingRights_ &= kCastlingMask[from] & kCastlingMask[to];
+    hash_ ^= zobrist::castling(castlingRights_);
+
+    // En passant only right after a pawn double-step, and only recorded when
+    // an enemy pawn can take it, so transposed positions hash the same
+    if (enPassantSquare_ >= 0)
+        hash_ ^= zobrist::enPassant(squareX(enPassantSquare_));
+    enPassantSquare_ = -1;
+    if (move.flag() == Move::DoublePush) {
+        int skipped = (from + to) / 2;
+        if (pawnAttacks(color, skipped) &
+            pieces_[typeIndex(PieceType::Pawn)] & colors_[colorIndex(enemy)]) {
+            enPassantSquare_ = skipped;
+            hash_ ^= zobrist::enPassant(squareX(skipped));
         }
+    }
 
-        // restore en-passant state
-        enPassant_.valid = oldEPValid;
-        enPassant_.x = oldEPx;
-        enPassant_.y = oldEPy;
+    if (type == PieceType::Pawn || undo.captured >= 0)
+        halfmoveClock_ = 0;
+    else if (halfmoveClock_ < UINT16_MAX)
+        ++halfmoveClock_;
+    if (color == Color::Black && fullmoveNumber_ < UINT16_MAX)
+        ++fullmoveNumber_;
+
+    // movePiece() lets either color move, so only flip the key on a real change
+    if (sideToMove_ != enemy)
+        hash_ ^= zobrist::blackToMove();
+    sideToMove_ = enemy;
+}
 
-        return false;
+void ChessBoard::unmakeMove() {
+    const UndoInfo& undo = undo_[--ply_];
+    Move move = undo.move;
+    int from = move.from();
+    int to   = move.to();
+
+    Color color = opposite(sideToMove_);
+    sideToMove_ = color;
+    castlingRights_ = undo.castlingRights;
+    enPassantSquare_ = undo.enPassantSquare;
+    halfmoveClock_ = undo.halfmoveClock;
+    fullmoveNumber_ = undo.fullmoveNumber;
+
+    if (move.isPromotion()) {
+        removePiece(to, color, move.promotion());
+        putPiece(to, color, PieceType::Pawn);
     }
 
-    /* ===================== UPDATE FLAGS (move succeeded) ===================== */
+    if (move.flag() == Move::Castle) {
+        int rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        shiftPiece(rookTo, rookFrom, color, PieceType::Rook);
+    }
 
-    if (piece->getType() == PieceType::King) {
-        if (piece->getColor() == Color::White) whiteKingMoved_ = true;
-        else blackKingMoved_ = true;
+    shiftPiece(to, from, color, squares_[to].getType());
+
+    if (undo.captured >= 0) {
+        int sq = (move.flag() == Move::EnPassant)
+            ? makeSquare(squareX(to), squareY(from))
+            : to;
+        putPiece(sq, opposite(color), static_cast<PieceType>(undo.captured));
     }
 
-    if (piece->getType() == PieceType::Rook) {
-        if (piece->getColor() == Color::White) {
-            if (fx == 0 && fy == 7) whiteRookAMoved_ = true;
-            if (fx == 7 && fy == 7) whiteRookHMoved_ = true;
-        } else {
-            if (fx == 0 && fy == 0) blackRookAMoved_ = true;
-            if (fx == 7 && fy == 0) blackRookHMoved_ = true;
-        }
+    // The piece helpers above XOR the key as they go; the saved key is exact
+    hash_ = undo.hash;
+}
+
+bool ChessBoard::isRepetition() const {
+    // Same side to move only: every second position back from here, first
+    // along the search line and then through the game before it, no
+    // further than the last capture or pawn move
+    int reach = std::min<int>(halfmoveClock_, ply_ + historyCount_);
+    for (int back = 2; back <= reach; back += 2) {
+        std::uint64_t key = back <= ply_ ? undo_[ply_ - back].hash
+                                         : history_[historyCount_ - (back - ply_)];
+        if (key == hash_)
+            return true;
     }
+    return false;
+}
 
-    // Enable en-passant ONLY after a successful pawn double-step
-    if (piece->getType() == PieceType::Pawn) {
-        int dir = (piece->getColor() == Color::White) ? -1 : +1;
-        if (fx == tx && ty == fy + 2 * dir) {
-            enPassant_.valid = true;
-            enPassant_.x = fx;
-            enPassant_.y = fy + dir;
-        } else {
-            enPassant_.valid = false;
-        }
-    } else {
-        // Non-pawn moves clear en-passant
-        enPassant_.valid = false;
+std::uint64_t ChessBoard::computeHash() const {
+    std::uint64_t key = 0;
+
+    for (Bitboard occ = occupied(); occ; ) {
+        int sq = popLsb(occ);
+        Piece piece = squares_[sq];
+        key ^= zobrist::piece(piece.getColor(), piece.getType(), sq);
     }
 
-    return true;
+    key ^= zobrist::castling(castlingRights_);
+    if (enPassantSquare_ >= 0)
+        key ^= zobrist::enPassant(squareX(enPassantSquare_));
+    if (sideToMove_ == Color::Black)
+        key ^= zobrist::blackToMove();
+
+    return key;
 }
 
 
-bool ChessBoard::isCheckmate(Color color) {
+bool ChessBoard::isCheckmate(Color color) const {
     // If king is not in check → not checkmate
     if (!isKingInCheck(color))
         return false;
 
-    // Try ALL possible moves for this color
-    for (int fy = 0; fy < 8; ++fy) {
-        for (int fx = 0; fx < 8; ++fx) {
-            if (!board_[fy][fx])
-                continue;
-
-            Piece* piece = board_[fy][fx].get();
-            if (piece->getColor() != color)
-                continue;
-
-            // Try every destination square
-            for (int ty = 0; ty < 8; ++ty) {
-                for (int tx = 0; tx < 8; ++tx) {
-
-                    // Skip same square
-                    if (fx == tx && fy == ty)
-                        continue;
-
-                    // Shape validation
-                    if (!piece->isValidMove(fx, fy, tx, ty))
-                        continue;
-
-                    // Prevent capturing own piece
-                    if (board_[ty][tx] &&
-                        board_[ty][tx]->getColor() == color)
-                        continue;
-
-                    // Path blocking
-                    PieceType t = piece->getType();
-                    if ((t == PieceType::Rook ||
-                         t == PieceType::Bishop ||
-                         t == PieceType::Queen) &&
-                        !isPathClear(fx, fy, tx, ty))
-                        continue;
-
-                    // --- simulate move ---
-                    auto captured = std::move(board_[ty][tx]);
-                    board_[ty][tx] = std::move(board_[fy][fx]);
-                    board_[fy][fx] = nullptr;
-
-                    bool stillInCheck = isKingInCheck(color);
-
-                    // revert
-                    board_[fy][fx] = std::move(board_[ty][tx]);
-                    board_[ty][tx] = std::move(captured);
-
-                    // If ANY move escapes check → not checkmate
-                    if (!stillInCheck)
-                        return false;
-                }
-            }
-        }
-    }
+    MoveList moves;
+    generateLegalMoves(color, ~Bitboard(0), moves);
+    return moves.empty();
+}
 
-    // No legal escape found
-    return true;
+bool ChessBoard::isStalemate(Color color) const {
+    if (isKingInCheck(color))
+        return false;
+
+    MoveList moves;
+    generateLegalMoves(color, ~Bitboard(0), moves);
+    return moves.empty();
 }
 
+GameStatus ChessBoard::status() const {
+    MoveList moves;
+    generateLegalMoves(sideToMove_, ~Bitboard(0), moves);
+    if (!moves.empty())
+        return GameStatus::Ongoing;
 
-bool ChessBoard::isKingInCheck(Color kingColor) const {
-    int kingX = -1, kingY = -1;
+    return isKingInCheck(sideToMove_) ? GameStatus::Checkmate
+                                      : GameStatus::Stalemate;
+}
 
-    // Locate the king
-    for (int y = 0; y < 8; ++y) {
-        for (int x = 0; x < 8; ++x) {
-            if (board_[y][x] &&
-                board_[y][x]->getType() == PieceType::King &&
-                board_[y][x]->getColor() == kingColor) {
-                kingX = x;
-                kingY = y;
-                break;
-            }
-        }
-    }
 
-    if (kingX == -1)
+bool ChessBoard::isKingInCheck(Color kingColor) const {
+    int kingSq = kingSquare_[colorIndex(kingColor)];
+    if (kingSq < 0)
         return false; // should never happen in valid game
 
-    // Check all enemy pieces
-    for (int y = 0; y < 8; ++y) {
-        for (int x = 0; x < 8; ++x) {
-            if (!board_[y][x])
-                continue;
-
-            Piece* enemy = board_[y][x].get();
-            if (enemy->getColor() == kingColor)
-                continue;
-
-            // Can this piece attack the king?
-            if (!enemy->isValidMove(x, y, kingX, kingY))
-                continue;
-
-            // Sliding pieces must have clear path
-            PieceType t = enemy->getType();
-            if (t == PieceType::Rook ||
-                t == PieceType::Bishop ||
-                t == PieceType::Queen) {
-                if (!isPathClear(x, y, kingX, kingY))
-                    continue;
-            }
-
-            // Pawn special case: only diagonal attack
-            if (t == PieceType::Pawn) {
-                int dir = (enemy->getColor() == Color::White) ? -1 : +1;
-                if (kingY != y + dir || std::abs(kingX - x) != 1)
-                    continue;
-            }
-
-            return true; // king is in check
-        }
-    }
+    return isAttacked(kingSq, opposite(kingColor), occupied(), 0);
+}
 
-    return false;
+bool ChessBoard::isSquareAttacked(int x, int y, Color byColor) const {
+    return isAttacked(makeSquare(x, y), byColor, occupied(), 0);
 }
 
-bool ChessBoard::isPathClear(int fromX, int fromY, int toX, int toY) const {
-    int dx = (toX > fromX) - (toX < fromX);
-    int dy = (toY > fromY) - (toY < fromY);
+bool ChessBoard::isAttacked(int sq, Color byColor, Bitboard occ,
+                            Bitboard ignore) const {
+    // "ignore" drops attackers that a hypothetical move would capture
+    Bitboard attackers = colors_[colorIndex(byColor)] & ~ignore;
 
-    int x = fromX + dx;
-    int y = fromY + dy;
+    // Look outwards from the target square: a piece of type T attacks sq
+    // exactly when sq "attacks" it with T's movement pattern.
+    // Pawns are the one asymmetric case, so use the defender's pawn table.
+    if (pawnAttacks(opposite(byColor), sq) &
+        pieces_[typeIndex(PieceType::Pawn)] & attackers)
+        return true;
+    if (knightAttacks(sq) & pieces_[typeIndex(PieceType::Knight)] & attackers)
+        return true;
+    if (kingAttacks(sq) & pieces_[typeIndex(PieceType::King)] & attackers)
+        return true;
 
-    while (x != toX || y != toY) {
-        if (board_[y][x] != nullptr)
-            return false;
+    Bitboard queens = pieces_[typeIndex(PieceType::Queen)];
+    if (rookAttacks(sq, occ) &
+        (pieces_[typeIndex(PieceType::Rook)] | queens) & attackers)
+        return true;
+    if (bishopAttacks(sq, occ) &
+        (pieces_[typeIndex(PieceType::Bishop)] | queens) & attackers)
+        return true;
 
-        x += dx;
-        y += dy;
-    }
-    return true;
+    return false;
 }
 
 
@@ -413,7 +433,8 @@ std::string ChessBoard::display() const {
     for (int y = 0; y < 8; ++y) {
         out << (8 - y) << "  ";
         for (int x = 0; x < 8; ++x) {
-            out << (board_[y][x] ? board_[y][x]->symbol() : '_');
+            const Piece* piece = getPiece(x, y);
+            out << (piece ? piece->symbol() : '_');
             if (x < 7) out << " ";
         }
         out << "\n";
@@ -1,11 +1,12 @@
 #include "chess/chess_piece.hpp"
 #include <cctype>
+#include <cstdlib>
 
 /* ---------- Common ---------- */
 
 char Piece::symbol() const {
-    char c;
-    switch (type_) {
+    char c = '?';
+    switch (getType()) {
         case PieceType::Pawn:   c = 'P'; break;
         case PieceType::Rook:   c = 'R'; break;
         case PieceType::Knight: c = 'N'; break;
@@ -13,61 +14,47 @@ char Piece::symbol() const {
         case PieceType::Queen:  c = 'Q'; break;
         case PieceType::King:   c = 'K'; break;
     }
-    return (color_ == Color::White) ? c : std::tolower(c);
+    return (getColor() == Color::White) ? c : std::tolower(c);
 }
 
-/* ---------- Pawn ---------- */
+/* ---------- Move shapes ---------- */
 
-bool Pawn::isValidMove(int fx, int fy, int tx, int ty) const {
-    int dir = (color_ == Color::White) ? -1 : +1;
-
-    // Forward move
-    if (fx == tx && ty == fy + dir)
-        return true;
-
-    // First double move
-    if (fx == tx) {
-        if (color_ == Color::White && fy == 6 && ty == 4) return true;
-        if (color_ == Color::Black && fy == 1 && ty == 3) return true;
-    }
-
-    // Diagonal move (capture checked at board level)
-    if (std::abs(tx - fx) == 1 && ty == fy + dir)
-        return true;
-
-    return false;
-}
-
-
-/* ---------- Rook ---------- */
+bool Piece::isValidMove(int fx, int fy, int tx, int ty) const {
+    int dx = std::abs(tx - fx);
+    int dy = std::abs(ty - fy);
 
-bool Rook::isValidMove(int fx, int fy, int tx, int ty) const {
-    return fx == tx || fy == ty;
-}
+    switch (getType()) {
+        case PieceType::Pawn: {
+            int dir = (getColor() == Color::White) ? -1 : +1;
 
-/* ---------- Knight ---------- */
+            // Forward move
+            if (fx == tx && ty == fy + dir)
+                return true;
 
-bool Knight::isValidMove(int fx, int fy, int tx, int ty) const {
-    int dx = std::abs(tx - fx);
-    int dy = std::abs(ty - fy);
-    return (dx == 2 && dy == 1) || (dx == 1 && dy == 2);
-}
+            // First double move
+            if (fx == tx) {
+                if (getColor() == Color::White && fy == 6 && ty == 4) return true;
+                if (getColor() == Color::Black && fy == 1 && ty == 3) return true;
+            }
 
-/* ---------- Bishop ---------- */
+            // Diagonal move (capture checked at board level)
+            return dx == 1 && ty == fy + dir;
+        }
 
-bool Bishop::isValidMove(int fx, int fy, int tx, int ty) const {
-    return std::abs(tx - fx) == std::abs(ty - fy);
-}
+        case PieceType::Rook:
+            return fx == tx || fy == ty;
 
-/* ---------- Queen ---------- */
+        case PieceType::Knight:
+            return (dx == 2 && dy == 1) || (dx == 1 && dy == 2);
 
-bool Queen::isValidMove(int fx, int fy, int tx, int ty) const {
-    return fx == tx || fy == ty ||
-           std::abs(tx - fx) == std::abs(ty - fy);
-}
+        case PieceType::Bishop:
+            return dx == dy;
 
-/* ---------- King ---------- */
+        case PieceType::Queen:
+            return fx == tx || fy == ty || dx == dy;
 
-bool King::isValidMove(int fx, int fy, int tx, int ty) const {
-    return std::abs(tx - fx) <= 1 && std::abs(ty - fy) <= 1;
+        case PieceType::King:
+            return dx <= 1 && dy <= 1;
+    }
+    return false;
 }
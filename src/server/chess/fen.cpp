@@ -0,0 +1,297 @@
+#include "chess/chess_board.hpp"
+#include "chess/attacks.hpp"
+#include "chess/zobrist.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// What each FEN character does in the placement field: how many squares
+// it covers, the piece it puts down and whether it ends a rank. Every
+// other character is marked bad.
+struct PlacementChar {
+    std::uint8_t squares = 0;
+    Piece piece;
+    std::uint8_t slash = 0;
+    std::uint8_t bad = 1;
+};
+
+constexpr std::array<PlacementChar, 256> buildPlacementTable() {
+    std::array<PlacementChar, 256> table{};
+    const char letters[] = "PRNBQK";
+    for (int type = 0; type < 6; ++type) {
+        table[letters[type]] = { 1, Piece(Color::White, static_cast<PieceType>(type)), 0, 0 };
+        table[letters[type] + ('a' - 'A')] =
+            { 1, Piece(Color::Black, static_cast<PieceType>(type)), 0, 0 };
+    }
+    for (int run = 1; run <= 8; ++run)
+        table['0' + run] = { static_cast<std::uint8_t>(run), Piece(), 0, 0 };
+    table['/'] = { 0, Piece(), 1, 0 };
+    return table;
+}
+
+constexpr std::array<PlacementChar, 256> kPlacementChars = buildPlacementTable();
+
+// Zobrist key of each piece code on each square; code 0 (empty) is all zero
+constexpr std::array<std::array<std::uint64_t, 64>, 16> buildPieceKeys() {
+    std::array<std::array<std::uint64_t, 64>, 16> keys{};
+    for (int color = 0; color < 2; ++color)
+        for (int type = 0; type < 6; ++type)
+            for (int sq = 0; sq < 64; ++sq)
+                keys[(type + 1) | (color << 3)][sq] = zobrist::kKeys.pieces[color][type][sq];
+    return keys;
+}
+
+constexpr auto kPieceKeys = buildPieceKeys();
+
+char letterOf(Piece piece) {
+    constexpr char letters[] = "PRNBQK";
+    char letter = letters[typeIndex(piece.getType())];
+    return piece.getColor() == Color::White ? letter : static_cast<char>(letter + ('a' - 'A'));
+}
+
+// The castling right of each FEN letter, and where its king and rook stand
+struct CastlingSide {
+    char letter;
+    CastlingRight right;
+    Color color;
+    int king, rook;
+};
+
+constexpr CastlingSide kCastlingSides[] = {
+    { 'K', WhiteKingSide,  Color::White, makeSquare(4, 7), makeSquare(7, 7) },
+    { 'Q', WhiteQueenSide, Color::White, makeSquare(4, 7), makeSquare(0, 7) },
+    { 'k', BlackKingSide,  Color::Black, makeSquare(4, 0), makeSquare(7, 0) },
+    { 'q', BlackQueenSide, Color::Black, makeSquare(4, 0), makeSquare(0, 0) },
+};
+
+// Reads the next field, skipping the spaces before it
+std::string_view nextField(const char*& at, const char* end) {
+    while (at < end && *at == ' ')
+        ++at;
+    const char* start = at;
+    const void* space = std::memchr(at, ' ', static_cast<std::size_t>(end - at));
+    at = space ? static_cast<const char*>(space) : end;
+    return { start, static_cast<std::size_t>(at - start) };
+}
+
+bool parseCounter(std::string_view field, std::uint16_t& value) {
+    auto [rest, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return error == std::errc() && rest == field.data() + field.size();
+}
+
+// Pieces of one position, as parsed, before any of it reaches a board
+struct Placement {
+    std::array<Piece, 64> squares{};
+    std::array<Bitboard, 6> pieces{};
+    std::array<Bitboard, 2> colors{};
+    std::array<int, 2> kings{};
+    std::uint64_t key = 0;
+
+    Bitboard of(Color color, PieceType type) const {
+        return pieces[typeIndex(type)] & colors[colorIndex(color)];
+    }
+
+    bool attacked(int sq, Color by) const {
+        Bitboard occ = colors[0] | colors[1];
+        Bitboard queens = of(by, PieceType::Queen);
+        return (pawnAttacks(opposite(by), sq) & of(by, PieceType::Pawn)) ||
+               (knightAttacks(sq) & of(by, PieceType::Knight)) ||
+               (kingAttacks(sq) & of(by, PieceType::King)) ||
+               (bishopAttacks(sq, occ) & (of(by, PieceType::Bishop) | queens)) ||
+               (rookAttacks(sq, occ) & (of(by, PieceType::Rook) | queens));
+    }
+};
+
+/*
+ * Rank 8 first, A to H: the same order as the squares themselves.
+ *
+ * Digits and letters come in no order a branch predictor could learn, so
+ * each character takes the same few steps without a branch: one table
+ * lookup, one store, one add. A rank is right if the slash closing it
+ * comes exactly 8 squares after the one before, so the rank length is
+ * checked there and not per character. Bitboards and the key are filled
+ * in afterwards from the occupied squares, fewer than the characters.
+ */
+bool parsePlacement(std::string_view field, Placement& placement) {
+    constexpr Bitboard kBackRanks = 0xFF000000000000FFULL;
+    unsigned sq = 0;
+    unsigned ranks = 0;
+    unsigned bad = 0;
+    Bitboard occupied = 0;
+
+    for (char c : field) {
+        const PlacementChar& entry = kPlacementChars[static_cast<unsigned char>(c)];
+        unsigned at = sq & 63;
+        placement.squares[at] = entry.piece;
+        occupied |= squareBB(static_cast<int>(at)) & -Bitboard(!entry.piece.isEmpty());
+        sq += entry.squares;
+        ranks += entry.slash;
+        bad |= entry.bad | (entry.slash & (sq != ranks * 8));
+    }
+    if (bad || sq != 64 || ranks != 7)
+        return false;
+
+    for (Bitboard left = occupied; left; ) {
+        int at = popLsb(left);
+        Piece piece = placement.squares[at];
+        placement.pieces[typeIndex(piece.getType())] |= squareBB(at);
+        placement.colors[colorIndex(piece.getColor())] |= squareBB(at);
+        placement.key ^= kPieceKeys[piece.raw()][at];
+    }
+
+    // Exactly one king a side, and no pawn on the first or last rank
+    Bitboard kings = placement.pieces[typeIndex(PieceType::King)];
+    Bitboard whiteKing = kings & placement.colors[colorIndex(Color::White)];
+    Bitboard blackKing = kings & placement.colors[colorIndex(Color::Black)];
+    if (popCount(whiteKing) != 1 || popCount(blackKing) != 1 ||
+        (placement.pieces[typeIndex(PieceType::Pawn)] & kBackRanks))
+        return false;
+
+    placement.kings[colorIndex(Color::White)] = lsb(whiteKing);
+    placement.kings[colorIndex(Color::Black)] = lsb(blackKing);
+    return true;
+}
+
+} // namespace
+
+/* ---------------- FEN ---------------- */
+
+bool ChessBoard::fromFEN(std::string_view fen) {
+    const char* at = fen.data();
+    const char* end = at + fen.size();
+
+    Placement placement;
+    if (!parsePlacement(nextField(at, end), placement))
+        return false;
+
+    std::string_view side = nextField(at, end);
+    if (side.size() != 1 || (side[0] != 'w' && side[0] != 'b'))
+        return false;
+    Color toMove = side[0] == 'w' ? Color::White : Color::Black;
+
+    // The side that just moved cannot have left its king in check
+    if (placement.attacked(placement.kings[colorIndex(opposite(toMove))], toMove))
+        return false;
+
+    // Rights without the king and rook at home could never be used
+    std::uint8_t castling = 0;
+    std::string_view rights = nextField(at, end);
+    if (rights != "-") {
+        if (rights.empty() || rights.size() > 4)
+            return false;
+        for (char c : rights) {
+            const CastlingSide* found = nullptr;
+            for (const CastlingSide& castlingSide : kCastlingSides)
+                if (castlingSide.letter == c)
+                    found = &castlingSide;
+            if (!found)
+                return false;
+
+            Piece king = placement.squares[found->king];
+            Piece rook = placement.squares[found->rook];
+            if (king == Piece(found->color, PieceType::King) &&
+                rook == Piece(found->color, PieceType::Rook))
+                castling |= found->right;
+        }
+    }
+
+    // Kept only where a pawn can take, as makeMove() does, so the same
+    // position always gets the same key
+    int enPassant = -1;
+    std::string_view target = nextField(at, end);
+    if (target != "-") {
+        int rank = toMove == Color::White ? '6' : '3';
+        if (target.size() != 2 || target[0] < 'a' || target[0] > 'h' || target[1] != rank)
+            return false;
+
+        int sq = makeSquare(target[0] - 'a', '8' - target[1]);
+        int pushed = sq + (toMove == Color::White ? 8 : -8);
+        if (placement.squares[pushed] == Piece(opposite(toMove), PieceType::Pawn) &&
+            placement.squares[sq].isEmpty() &&
+            (pawnAttacks(opposite(toMove), sq) & placement.of(toMove, PieceType::Pawn)))
+            enPassant = sq;
+    }
+
+    std::uint16_t halfmove = 0;
+    std::uint16_t fullmove = 1;
+    std::string_view field = nextField(at, end);
+    if (!field.empty() && !parseCounter(field, halfmove))
+        return false;
+    field = nextField(at, end);
+    if (!field.empty() && (!parseCounter(field, fullmove) || fullmove == 0))
+        return false;
+    if (!nextField(at, end).empty())
+        return false;
+
+    // Everything checked; only now does the board change
+    pieces_ = placement.pieces;
+    colors_ = placement.colors;
+    squares_ = placement.squares;
+    kingSquare_ = placement.kings;
+    sideToMove_ = toMove;
+    castlingRights_ = castling;
+    enPassantSquare_ = enPassant;
+    halfmoveClock_ = halfmove;
+    fullmoveNumber_ = fullmove;
+    ply_ = 0;
+    historyCount_ = 0;
+    hash_ = placement.key ^ zobrist::castling(castling);
+    if (enPassant >= 0)
+        hash_ ^= zobrist::enPassant(squareX(enPassant));
+    if (toMove == Color::Black)
+        hash_ ^= zobrist::blackToMove();
+    return true;
+}
+
+std::size_t ChessBoard::toFEN(char* out) const {
+    char* at = out;
+
+    for (int y = 0; y < 8; ++y) {
+        int empty = 0;
+        for (int x = 0; x < 8; ++x) {
+            Piece piece = squares_[makeSquare(x, y)];
+            if (piece.isEmpty()) {
+                ++empty;
+                continue;
+            }
+            if (empty)
+                *at++ = static_cast<char>('0' + empty);
+            empty = 0;
+            *at++ = letterOf(piece);
+        }
+        if (empty)
+            *at++ = static_cast<char>('0' + empty);
+        if (y < 7)
+            *at++ = '/';
+    }
+
+    *at++ = ' ';
+    *at++ = sideToMove_ == Color::White ? 'w' : 'b';
+
+    *at++ = ' ';
+    if (castlingRights_ == 0)
+        *at++ = '-';
+    for (const CastlingSide& side : kCastlingSides)
+        if (castlingRights_ & side.right)
+            *at++ = side.letter;
+
+    *at++ = ' ';
+    if (enPassantSquare_ < 0) {
+        *at++ = '-';
+    }
+    else {
+        *at++ = static_cast<char>('a' + squareX(enPassantSquare_));
+        *at++ = static_cast<char>('8' - squareY(enPassantSquare_));
+    }
+
+    // Two numbers of at most five digits each fit in what is left
+    *at++ = ' ';
+    at = std::to_chars(at, out + kMaxFEN, halfmoveClock_).ptr;
+    *at++ = ' ';
+    at = std::to_chars(at, out + kMaxFEN, fullmoveNumber_).ptr;
+
+    *at = '\0';
+    return static_cast<std::size_t>(at - out);
+}
@@ -0,0 +1,44 @@
+#include "chess/mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path, Access access) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path + ": " + std::strerror(error));
+    }
+
+    // An empty file cannot be mapped, and has nothing to read anyway
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ > 0) {
+        void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path + ": " + std::strerror(error));
+        }
+        ::madvise(map, size_, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        data_ = static_cast<const char*>(map);
+    }
+
+    // The mapping stays valid without the descriptor
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+}
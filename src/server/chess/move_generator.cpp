@@ -0,0 +1,184 @@
+#include "chess/chess_board.hpp"
+#include "chess/attacks.hpp"
+
+namespace {
+
+void addPawnMove(MoveList& moves, int from, int to, bool promotes) {
+    if (!promotes) {
+        moves.push_back(Move(from, to));
+        return;
+    }
+    moves.push_back(Move(from, to, Move::PromoQueen));
+    moves.push_back(Move(from, to, Move::PromoRook));
+    moves.push_back(Move(from, to, Move::PromoBishop));
+    moves.push_back(Move(from, to, Move::PromoKnight));
+}
+
+void addMoves(MoveList& moves, int from, Bitboard targets) {
+    while (targets)
+        moves.push_back(Move(from, popLsb(targets)));
+}
+
+} // namespace
+
+/* ---------------- Public API ---------------- */
+
+void ChessBoard::generateLegalMoves(MoveList& moves) const {
+    generateLegalMoves(sideToMove_, ~Bitboard(0), moves);
+}
+
+/* ---------------- Legality filter ---------------- */
+
+void ChessBoard::generateLegalMoves(Color color, Bitboard fromMask,
+                                    MoveList& moves) const {
+    MoveList pseudo;
+    generatePseudoMoves(color, fromMask, pseudo);
+
+    moves.clear();
+    for (Move move : pseudo)
+        if (isLegal(move, color))
+            moves.push_back(move);
+}
+
+bool ChessBoard::isLegal(Move move, Color color) const {
+    int kingSq = kingSquare_[colorIndex(color)];
+    if (kingSq < 0)
+        return true; // no king to protect (test positions)
+
+    Color enemy = opposite(color);
+    Bitboard fromBB = squareBB(move.from());
+    Bitboard toBB = squareBB(move.to());
+
+    // King moves: test the landing square with the king lifted off the
+    // board, so a slider checking along the line still sees through it.
+    // (Castling's path was already checked when it was generated.)
+    if (move.from() == kingSq)
+        return !isAttacked(move.to(), enemy, occupied() ^ fromBB, 0);
+
+    // Other moves: look at the king with the occupancy after the move,
+    // ignoring whatever the move captures
+    Bitboard occ = (occupied() ^ fromBB) | toBB;
+    Bitboard captured = toBB;
+
+    if (move.flag() == Move::EnPassant) {
+        Bitboard pawn = squareBB(makeSquare(squareX(move.to()), squareY(move.from())));
+        occ ^= pawn;
+        captured = pawn;
+    }
+
+    return !isAttacked(kingSq, enemy, occ, captured);
+}
+
+/* ---------------- Pseudo-legal moves ---------------- */
+
+void ChessBoard::generatePseudoMoves(Color color, Bitboard fromMask,
+                                     MoveList& moves) const {
+    Bitboard own   = colors_[colorIndex(color)];
+    Bitboard enemy = colors_[colorIndex(opposite(color))];
+    Bitboard occ   = own | enemy;
+
+    /* ---- Pawns ---- */
+    int step       = (color == Color::White) ? -8 : +8;
+    int startY     = (color == Color::White) ? 6 : 1;
+    int promoY     = (color == Color::White) ? 0 : 7;
+    int epCaptureY = (color == Color::White) ? 2 : 5;
+
+    Bitboard epTarget = 0;
+    if (enPassantSquare_ >= 0 && squareY(enPassantSquare_) == epCaptureY)
+        epTarget = squareBB(enPassantSquare_);
+
+    for (Bitboard pawns = pieces_[typeIndex(PieceType::Pawn)] & own & fromMask; pawns; ) {
+        int from = popLsb(pawns);
+        int push = from + step;
+        bool promotes = squareY(push) == promoY;
+
+        // Forward pushes
+        if (!(occ & squareBB(push))) {
+            addPawnMove(moves, from, push, promotes);
+
+            int doublePush = push + step;
+            if (squareY(from) == startY && !(occ & squareBB(doublePush)))
+                moves.push_back(Move(from, doublePush, Move::DoublePush));
+        }
+
+        // Captures, including en passant
+        Bitboard attacks = pawnAttacks(color, from);
+        for (Bitboard captures = attacks & enemy; captures; )
+            addPawnMove(moves, from, popLsb(captures), promotes);
+        if (attacks & epTarget)
+            moves.push_back(Move(from, lsb(epTarget), Move::EnPassant));
+    }
+
+    /* ---- Pieces ---- */
+    Bitboard targets = ~own;
+
+    for (Bitboard b = pieces_[typeIndex(PieceType::Knight)] & own & fromMask; b; ) {
+        int from = popLsb(b);
+        addMoves(moves, from, knightAttacks(from) & targets);
+    }
+
+    for (Bitboard b = pieces_[typeIndex(PieceType::Bishop)] & own & fromMask; b; ) {
+        int from = popLsb(b);
+        addMoves(moves, from, bishopAttacks(from, occ) & targets);
+    }
+
+    for (Bitboard b = pieces_[typeIndex(PieceType::Rook)] & own & fromMask; b; ) {
+        int from = popLsb(b);
+        addMoves(moves, from, rookAttacks(from, occ) & targets);
+    }
+
+    for (Bitboard b = pieces_[typeIndex(PieceType::Queen)] & own & fromMask; b; ) {
+        int from = popLsb(b);
+        addMoves(moves, from, queenAttacks(from, occ) & targets);
+    }
+
+    int kingSq = kingSquare_[colorIndex(color)];
+    if (kingSq >= 0 && (fromMask & squareBB(kingSq))) {
+        addMoves(moves, kingSq, kingAttacks(kingSq) & targets);
+        generateCastling(color, moves);
+    }
+}
+
+void ChessBoard::generateCastling(Color color, MoveList& moves) const {
+    bool isWhite = (color == Color::White);
+    int y = isWhite ? 7 : 0;
+    int kingSq = makeSquare(4, y);
+    Color enemy = opposite(color);
+
+    std::uint8_t rights = castlingRights_ &
+        (isWhite ? (WhiteKingSide | WhiteQueenSide)
+                 : (BlackKingSide | BlackQueenSide));
+
+    // King must be on its home square, keep some right and not be in check
+    if (!rights)
+        return;
+    if (kingSquare_[colorIndex(color)] != kingSq)
+        return;
+    if (isAttacked(kingSq, enemy, occupied(), 0))
+        return;
+
+    Bitboard ownRooks = pieces_[typeIndex(PieceType::Rook)] &
+                        colors_[colorIndex(color)];
+
+    for (bool kingSide : { true, false }) {
+        std::uint8_t right = isWhite
+            ? (kingSide ? WhiteKingSide : WhiteQueenSide)
+            : (kingSide ? BlackKingSide : BlackQueenSide);
+        int rookSq = makeSquare(kingSide ? 7 : 0, y);
+        if (!(rights & right) || !(ownRooks & squareBB(rookSq)))
+            continue;
+
+        // Every square between king and rook must be empty: the rook's
+        // attacks along the rank reach the king exactly when that holds
+        if (!(rookAttacks(rookSq, occupied()) & squareBB(kingSq)))
+            continue;
+
+        // King cannot pass through check; the landing square is
+        // covered by the legality filter like any other move
+        int dir = kingSide ? 1 : -1;
+        if (isAttacked(kingSq + dir, enemy, occupied(), 0))
+            continue;
+
+        moves.push_back(Move(kingSq, kingSq + 2 * dir, Move::Castle));
+    }
+}
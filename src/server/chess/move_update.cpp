@@ -0,0 +1,102 @@
+#include "chess/move_update.hpp"
+
+#include <charconv>
+
+namespace {
+
+const char* const kStatusNames[] = { "ONGOING", "CHECKMATE", "STALEMATE" };
+
+// Next whitespace-separated word (a trailing "\r\n" is whitespace too)
+std::string_view nextWord(std::string_view& rest) {
+    std::size_t start = rest.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos)
+        return rest = {};
+    rest.remove_prefix(start);
+    std::string_view word = rest.substr(0, rest.find_first_of(" \t\r\n"));
+    rest.remove_prefix(word.size());
+    return word;
+}
+
+bool parseHex(std::string_view text, std::uint64_t& value) {
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value, 16);
+    return !text.empty() && ec == std::errc() && ptr == end;
+}
+
+} // namespace
+
+std::string formatMoveUpdate(const MoveUpdate& update) {
+    char hash[17];
+    static const char digits[] = "0123456789abcdef";
+    for (int i = 0; i < 16; ++i)
+        hash[i] = digits[(update.hash >> (60 - 4 * i)) & 0xF];
+    hash[16] = '\0';
+
+    return "MOVED " + update.move.toString() + " " +
+           (update.sideToMove == Color::White ? "WHITE " : "BLACK ") +
+           kStatusNames[static_cast<int>(update.status)] + " " + hash + "\n";
+}
+
+bool parseMoveUpdate(std::string_view line, MoveUpdate& update) {
+    if (nextWord(line) != "MOVED")
+        return false;
+
+    update.move = Move::fromString(nextWord(line));
+    if (update.move.isNull())
+        return false;
+
+    std::string_view side = nextWord(line);
+    if (side != "WHITE" && side != "BLACK")
+        return false;
+    update.sideToMove = side == "WHITE" ? Color::White : Color::Black;
+
+    std::string_view status = nextWord(line);
+    int index = 0;
+    while (index < 3 && status != kStatusNames[index])
+        ++index;
+    if (index == 3)
+        return false;
+    update.status = static_cast<GameStatus>(index);
+
+    return parseHex(nextWord(line), update.hash);
+}
+
+std::string formatPosition(const PackedPosition& packed) {
+    static const char digits[] = "0123456789abcdef";
+    std::string line = "POSITION ";
+    for (std::uint8_t byte : packed.bytes) {
+        line += digits[byte >> 4];
+        line += digits[byte & 0xF];
+    }
+    return line + "\n";
+}
+
+bool parsePosition(std::string_view line, PackedPosition& packed) {
+    if (nextWord(line) != "POSITION")
+        return false;
+
+    std::string_view hex = nextWord(line);
+    if (hex.size() != 2 * packed.bytes.size())
+        return false;
+
+    for (std::size_t i = 0; i < packed.bytes.size(); ++i) {
+        std::uint64_t byte;
+        if (!parseHex(hex.substr(2 * i, 2), byte))
+            return false;
+        packed.bytes[i] = static_cast<std::uint8_t>(byte);
+    }
+    return true;
+}
+
+bool applyMoveUpdate(ChessBoard& board, const MoveUpdate& update) {
+    Move move = update.move;
+    Move legal = board.findMove(
+        squareX(move.from()), squareY(move.from()),
+        squareX(move.to()), squareY(move.to()),
+        move.isPromotion() ? move.promotion() : PieceType::Queen);
+    if (legal.isNull())
+        return false;
+
+    board.playMove(legal);
+    return board.hash() == update.hash;
+}
@@ -0,0 +1,120 @@
+#include "chess/packed_position.hpp"
+#include "chess/chess_board.hpp"
+#include "chess/zobrist.hpp"
+
+namespace {
+
+constexpr std::uint8_t kEnPassantPawn = 12;
+constexpr std::uint8_t kCastlingRook  = 13;
+constexpr std::uint8_t kKingToMove    = 14;
+
+// Castling right that belongs to a rook on its home square, or 0
+std::uint8_t castlingRightAt(int sq) {
+    switch (sq) {
+        case makeSquare(7, 7): return WhiteKingSide;
+        case makeSquare(0, 7): return WhiteQueenSide;
+        case makeSquare(7, 0): return BlackKingSide;
+        case makeSquare(0, 0): return BlackQueenSide;
+        default:               return 0;
+    }
+}
+
+// Square of the pawn that made an en passant square possible
+int enPassantPawnSquare(int epSquare) {
+    return squareY(epSquare) == 5 ? epSquare - 8  // white pawn on rank 4
+                                  : epSquare + 8; // black pawn on rank 5
+}
+
+} // namespace
+
+PackedPosition packPosition(const BoardSnapshot& s) {
+    PackedPosition packed;
+    Bitboard occ = s.colors[0] | s.colors[1];
+
+    for (int i = 0; i < 8; ++i)
+        packed.bytes[i] = static_cast<std::uint8_t>(occ >> (8 * i));
+
+    int epPawn = s.enPassantSquare >= 0 ? enPassantPawnSquare(s.enPassantSquare) : -1;
+
+    int index = 0;
+    for (Bitboard b = occ; b && index < 32; ++index) {
+        int sq = popLsb(b);
+        Piece piece = s.pieceAt(squareX(sq), squareY(sq));
+        PieceType type = piece.getType();
+
+        std::uint8_t code = static_cast<std::uint8_t>(
+            typeIndex(type) + 6 * colorIndex(piece.getColor()));
+
+        if (sq == epPawn && type == PieceType::Pawn)
+            code = kEnPassantPawn;
+        else if (type == PieceType::Rook && (s.castlingRights & castlingRightAt(sq)))
+            code = kCastlingRook;
+        else if (type == PieceType::King && piece.getColor() == Color::Black &&
+                 s.side() == Color::Black)
+            code = kKingToMove;
+
+        packed.bytes[8 + index / 2] |= static_cast<std::uint8_t>(
+            index % 2 ? code << 4 : code);
+    }
+
+    return packed;
+}
+
+bool unpackPosition(const PackedPosition& packed, BoardSnapshot& s) {
+    s = BoardSnapshot{};
+    s.enPassantSquare = -1;
+    s.sideToMove = static_cast<std::uint8_t>(colorIndex(Color::White));
+
+    Bitboard occ = 0;
+    for (int i = 0; i < 8; ++i)
+        occ |= Bitboard(packed.bytes[i]) << (8 * i);
+
+    if (popCount(occ) > 32)
+        return false;
+
+    int index = 0;
+    for (Bitboard b = occ; b; ++index) {
+        int sq = popLsb(b);
+        std::uint8_t byte = packed.bytes[8 + index / 2];
+        std::uint8_t code = index % 2 ? byte >> 4 : byte & 0xF;
+
+        Color color;
+        PieceType type;
+
+        if (code < 12) {
+            color = code < 6 ? Color::White : Color::Black;
+            type = static_cast<PieceType>(code % 6);
+        } else if (code == kEnPassantPawn) {
+            if (squareY(sq) != 4 && squareY(sq) != 3)
+                return false;
+            color = squareY(sq) == 4 ? Color::White : Color::Black;
+            type = PieceType::Pawn;
+            s.enPassantSquare = static_cast<std::int8_t>(
+                color == Color::White ? sq + 8 : sq - 8);
+        } else if (code == kCastlingRook) {
+            std::uint8_t right = castlingRightAt(sq);
+            if (!right)
+                return false;
+            color = squareY(sq) == 7 ? Color::White : Color::Black;
+            type = PieceType::Rook;
+            s.castlingRights |= right;
+        } else if (code == kKingToMove) {
+            color = Color::Black;
+            type = PieceType::King;
+            s.sideToMove = static_cast<std::uint8_t>(colorIndex(Color::Black));
+        } else {
+            return false;
+        }
+
+        s.pieces[typeIndex(type)] |= squareBB(sq);
+        s.colors[colorIndex(color)] |= squareBB(sq);
+        s.hash ^= zobrist::piece(color, type, sq);
+    }
+
+    s.hash ^= zobrist::castling(s.castlingRights);
+    if (s.enPassantSquare >= 0)
+        s.hash ^= zobrist::enPassant(squareX(s.enPassantSquare));
+    if (s.side() == Color::Black)
+        s.hash ^= zobrist::blackToMove();
+    return true;
+}
@@ -0,0 +1,21 @@
+#include "chess/perft.hpp"
+
+std::uint64_t perft(ChessBoard& board, int depth) {
+    if (depth <= 0)
+        return 1;
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+
+    // Bulk count: the last ply only needs the number of legal moves
+    if (depth == 1)
+        return moves.size();
+
+    std::uint64_t nodes = 0;
+    for (Move move : moves) {
+        board.makeMove(move);
+        nodes += perft(board, depth - 1);
+        board.unmakeMove();
+    }
+    return nodes;
+}
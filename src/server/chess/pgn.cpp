@@ -0,0 +1,274 @@
+#include "chess/pgn.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Characters that end a move token besides white space
+bool endsToken(char c) {
+    return isSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' ||
+           c == ';' || c == '$';
+}
+
+bool isResult(std::string_view token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+// Start of the line after the one `at` is on
+const char* nextLine(const char* at, const char* end) {
+    const void* newline = std::memchr(at, '\n', static_cast<std::size_t>(end - at));
+    return newline ? static_cast<const char*>(newline) + 1 : end;
+}
+
+// Just past the '}' closing the comment `at` is in
+const char* commentEnd(const char* at, const char* end) {
+    const void* brace = std::memchr(at, '}', static_cast<std::size_t>(end - at));
+    return brace ? static_cast<const char*>(brace) + 1 : end;
+}
+
+// [Name "value"], with `at` on the '['; false if the line is not one
+bool parseTag(const char* at, const char* end, PgnTag& tag) {
+    ++at;
+    while (at < end && (*at == ' ' || *at == '\t'))
+        ++at;
+    const char* name = at;
+    while (at < end && !isSpace(*at) && *at != '"' && *at != ']')
+        ++at;
+    if (at == name)
+        return false;
+    tag.name = { name, static_cast<std::size_t>(at - name) };
+
+    while (at < end && (*at == ' ' || *at == '\t'))
+        ++at;
+    if (at == end || *at != '"')
+        return false;
+
+    const char* value = ++at;
+    while (at < end && *at != '"' && *at != '\n') {
+        if (*at == '\\' && at + 1 < end)
+            ++at;
+        ++at;
+    }
+    if (at == end || *at != '"')
+        return false;
+    tag.value = { value, static_cast<std::size_t>(at - value) };
+    return true;
+}
+
+// First line at or after `from` that starts a game: one beginning with '['
+// where the line before does not (it is blank, or moves)
+std::size_t gameStart(std::string_view text, std::size_t from) {
+    for (;;) {
+        std::size_t newline = text.find("\n[", from == 0 ? 0 : from - 1);
+        if (newline == std::string_view::npos)
+            return text.size();
+
+        std::size_t before = newline == 0 ? std::string_view::npos
+                                          : text.rfind('\n', newline - 1);
+        std::size_t previous = before == std::string_view::npos ? 0 : before + 1;
+        if (text[previous] != '[')
+            return newline + 1;
+        from = newline + 2;
+    }
+}
+
+} // namespace
+
+/* ---------------- PgnGame ---------------- */
+
+std::string_view PgnGame::tag(std::string_view name) const {
+    for (std::size_t i = 0; i < tagCount; ++i)
+        if (tags[i].name == name)
+            return tags[i].value;
+    return {};
+}
+
+/* ---------------- PgnMoves ---------------- */
+
+bool PgnMoves::next(std::string_view& san) {
+    while (at_ < end_) {
+        char c = *at_;
+
+        if (isSpace(c) || c == ')' || c == '}') {
+            ++at_;
+            continue;
+        }
+        if (c == '{') {
+            at_ = commentEnd(at_, end_);
+            continue;
+        }
+        if (c == ';') {
+            at_ = nextLine(at_, end_);
+            continue;
+        }
+        if (c == '$') {
+            for (++at_; at_ < end_ && isDigit(*at_); )
+                ++at_;
+            continue;
+        }
+        if (c == '(') {
+            // Variations nest, and may hold comments with parentheses
+            int depth = 0;
+            while (at_ < end_) {
+                char v = *at_++;
+                if (v == '(')
+                    ++depth;
+                else if (v == ')' && --depth == 0)
+                    break;
+                else if (v == '{')
+                    at_ = commentEnd(at_, end_);
+                else if (v == ';')
+                    at_ = nextLine(at_, end_);
+            }
+            continue;
+        }
+
+        const char* start = at_;
+        while (at_ < end_ && !endsToken(*at_))
+            ++at_;
+        std::string_view token(start, static_cast<std::size_t>(at_ - start));
+
+        // Move numbers, "12." or "12...", sometimes run into the move as
+        // in "12.e4"; only what follows the dots is read again
+        if (c >= '1' && c <= '9') {
+            std::size_t digits = 1;
+            while (digits < token.size() && isDigit(token[digits]))
+                ++digits;
+            if (digits < token.size() && token[digits] == '.') {
+                while (digits < token.size() && token[digits] == '.')
+                    ++digits;
+                at_ = start + digits;
+                continue;
+            }
+        }
+
+        if (isResult(token)) {
+            result_ = token;
+            at_ = end_;
+            return false;
+        }
+        san = token;
+        return true;
+    }
+    return false;
+}
+
+/* ---------------- Replay ---------------- */
+
+PgnReplay replayGame(const PgnGame& game, ChessBoard& board) {
+    PgnReplay replay;
+
+    std::string_view fen = game.tag("FEN");
+    if (fen.empty()) {
+        board.initialize();
+    }
+    else if (!board.fromFEN(fen)) {
+        replay.failed = fen;
+        return replay;
+    }
+
+    PgnMoves moves(game.movetext);
+    std::string_view san;
+    while (moves.next(san)) {
+        Move move = board.fromSAN(san);
+        if (move.isNull()) {
+            replay.failed = san;
+            return replay;
+        }
+        board.playMove(move);
+        ++replay.plies;
+    }
+
+    replay.result = moves.result();
+    return replay;
+}
+
+/* ---------------- PgnReader ---------------- */
+
+PgnReader::PgnReader(const std::string& path)
+    : file_(std::make_unique<MappedFile>(path)),
+      data_(file_->data()),
+      size_(file_->size()) {}
+
+PgnReader::PgnReader(std::string_view text)
+    : data_(text.data()), size_(text.size()) {}
+
+PgnReader::~PgnReader() = default;
+
+bool PgnReader::next(PgnGame& game) {
+    const char* end = data_ + size_;
+    const char* at = data_ + at_;
+
+    // Blank lines and escape lines between games
+    for (;;) {
+        while (at < end && isSpace(*at))
+            ++at;
+        if (at < end && *at == '%') {
+            at = nextLine(at, end);
+            continue;
+        }
+        break;
+    }
+    if (at == end) {
+        at_ = size_;
+        return false;
+    }
+
+    const char* start = at;
+    game.tagCount = 0;
+    while (at < end && *at == '[') {
+        PgnTag tag;
+        if (parseTag(at, end, tag) && game.tagCount < PgnGame::kMaxTags)
+            game.tags[game.tagCount++] = tag;
+        at = nextLine(at, end);
+        while (at < end && isSpace(*at))
+            ++at;
+    }
+
+    // The moves run up to the next line that starts with '['. Movetext
+    // itself hardly ever holds a '[', so this is mostly one memchr().
+    const char* moves = at;
+    const char* stop = end;
+    for (const char* from = moves; from < end; ) {
+        const char* bracket = static_cast<const char*>(
+            std::memchr(from, '[', static_cast<std::size_t>(end - from)));
+        if (!bracket)
+            break;
+        if (bracket[-1] == '\n') {
+            stop = bracket;
+            break;
+        }
+        from = bracket + 1;
+    }
+
+    const char* last = stop;
+    while (last > moves && isSpace(last[-1]))
+        --last;
+    game.movetext = { moves, static_cast<std::size_t>(last - moves) };
+    game.text = { start, static_cast<std::size_t>(last - start) };
+    at_ = static_cast<std::size_t>(stop - data_);
+    return true;
+}
+
+std::vector<std::string_view> splitGames(std::string_view text, std::size_t parts) {
+    std::vector<std::string_view> pieces;
+    std::size_t start = 0;
+
+    for (std::size_t i = 1; i <= parts && start < text.size(); ++i) {
+        std::size_t cut = i == parts
+            ? text.size()
+            : gameStart(text, std::max(start + 1, text.size() / parts * i));
+        pieces.push_back(text.substr(start, cut - start));
+        start = cut;
+    }
+    return pieces;
+}
@@ -0,0 +1,185 @@
+#include "chess/chess_board.hpp"
+#include "chess/attacks.hpp"
+
+namespace {
+
+constexpr char kPieceLetters[] = "PRNBQK";
+
+constexpr Bitboard kFileA = 0x0101010101010101ULL;
+constexpr Bitboard kRank8 = 0xFFULL;
+
+// Piece type of an upper-case SAN letter ("P" included)
+bool pieceOfLetter(char c, PieceType& type) {
+    for (int i = 0; i < 6; ++i) {
+        if (kPieceLetters[i] == c) {
+            type = static_cast<PieceType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isAnnotation(char c) {
+    return c == '+' || c == '#' || c == '!' || c == '?';
+}
+
+} // namespace
+
+/* ---------------- SAN ---------------- */
+
+Move ChessBoard::fromSAN(std::string_view san) const {
+    while (!san.empty() && isAnnotation(san.back()))
+        san.remove_suffix(1);
+
+    Color us = sideToMove_;
+    MoveList moves;
+
+    // Castling, written with the letter O or the digit zero
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        int kingSq = kingSquare_[colorIndex(us)];
+        if (kingSq < 0)
+            return Move();
+
+        bool kingSide = san.size() == 3;
+        generateLegalMoves(us, squareBB(kingSq), moves);
+        for (Move move : moves)
+            if (move.flag() == Move::Castle && (move.to() > move.from()) == kingSide)
+                return move;
+        return Move();
+    }
+
+    PieceType type = PieceType::Pawn;
+    if (!san.empty() && san[0] != 'P' && pieceOfLetter(san[0], type))
+        san.remove_prefix(1);
+
+    // "e8=Q", or "e8Q" as some programs write it
+    bool promotes = false;
+    PieceType promotion = PieceType::Queen;
+    if (!san.empty() && pieceOfLetter(san.back(), promotion)) {
+        promotes = true;
+        san.remove_suffix(1);
+        if (!san.empty() && san.back() == '=')
+            san.remove_suffix(1);
+    }
+
+    if (san.size() < 2)
+        return Move();
+    int tx = san[san.size() - 2] - 'a';
+    int ty = '8' - san[san.size() - 1];
+    if (tx < 0 || tx > 7 || ty < 0 || ty > 7)
+        return Move();
+    san.remove_suffix(2);
+    if (!san.empty() && san.back() == 'x')
+        san.remove_suffix(1);
+
+    // What is left says which of several pieces moves: a file, a rank or both
+    if (san.size() > 2)
+        return Move();
+    Bitboard from = pieces(us, type);
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h')
+            from &= kFileA << (c - 'a');
+        else if (c >= '1' && c <= '8')
+            from &= kRank8 << (8 * ('8' - c));
+        else
+            return Move();
+    }
+
+    // Of those, only pieces that reach the square can be meant: moves
+    // are generated for them alone, and only the ones landing there are
+    // checked for legality
+    int to = makeSquare(tx, ty);
+    Bitboard occ = occupied();
+    switch (type) {
+        case PieceType::Pawn: {
+            // Along the file, or taking from the one next to it
+            Bitboard file = kFileA << tx;
+            from &= file | ((file << 1) & ~kFileA) | ((file >> 1) & ~(kFileA << 7));
+            break;
+        }
+        case PieceType::Knight: from &= knightAttacks(to); break;
+        case PieceType::Bishop: from &= bishopAttacks(to, occ); break;
+        case PieceType::Rook:   from &= rookAttacks(to, occ); break;
+        case PieceType::Queen:  from &= queenAttacks(to, occ); break;
+        case PieceType::King:   from &= kingAttacks(to); break;
+    }
+    generatePseudoMoves(us, from, moves);
+
+    Move found;
+    for (Move move : moves) {
+        if (move.to() != to || move.flag() == Move::Castle)
+            continue;
+        if (move.isPromotion() != promotes ||
+            (promotes && move.promotion() != promotion))
+            continue;
+        if (!isLegal(move, us))
+            continue;
+        if (!found.isNull())
+            return Move(); // ambiguous
+        found = move;
+    }
+    return found;
+}
+
+std::size_t ChessBoard::toSAN(Move move, char* out) const {
+    char* at = out;
+    int from = move.from();
+    int to = move.to();
+
+    Color us;
+    PieceType type;
+    pieceAt(from, us, type);
+
+    if (move.flag() == Move::Castle) {
+        for (char c : std::string_view(to > from ? "O-O" : "O-O-O"))
+            *at++ = c;
+    }
+    else {
+        bool capture = (occupied() & squareBB(to)) || move.flag() == Move::EnPassant;
+
+        if (type == PieceType::Pawn) {
+            if (capture)
+                *at++ = static_cast<char>('a' + squareX(from));
+        }
+        else {
+            *at++ = kPieceLetters[typeIndex(type)];
+
+            // Name the file, else the rank, else both, if another piece
+            // of the same kind could go to the same square
+            MoveList others;
+            generateLegalMoves(us, pieces(us, type) & ~squareBB(from), others);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (Move other : others) {
+                if (other.to() != to)
+                    continue;
+                ambiguous = true;
+                sameFile |= squareX(other.from()) == squareX(from);
+                sameRank |= squareY(other.from()) == squareY(from);
+            }
+            if (ambiguous && (!sameFile || sameRank))
+                *at++ = static_cast<char>('a' + squareX(from));
+            if (ambiguous && sameFile)
+                *at++ = static_cast<char>('8' - squareY(from));
+        }
+
+        if (capture)
+            *at++ = 'x';
+        *at++ = static_cast<char>('a' + squareX(to));
+        *at++ = static_cast<char>('8' - squareY(to));
+
+        if (move.isPromotion()) {
+            *at++ = '=';
+            *at++ = kPieceLetters[typeIndex(move.promotion())];
+        }
+    }
+
+    // Boards copy as plain memory, so trying the move on a copy is cheap
+    // and keeps this const
+    ChessBoard after = *this;
+    after.playMove(move);
+    if (after.isKingInCheck(after.sideToMove()))
+        *at++ = after.status() == GameStatus::Checkmate ? '#' : '+';
+
+    *at = '\0';
+    return static_cast<std::size_t>(at - out);
+}
@@ -0,0 +1,89 @@
+#include "analysis_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+AnalysisPool::AnalysisPool(TranspositionTable& table, int workers,
+                           int threadsPerSearch, std::size_t maxQueued)
+    : maxQueued_(maxQueued) {
+    workers = std::max(workers, 1);
+    for (int i = 0; i < workers; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->search = std::make_unique<ParallelSearch>(table, threadsPerSearch);
+        workers_.push_back(std::move(worker));
+    }
+    // Threads start once every worker exists, so none sees a half-built pool
+    for (auto& worker : workers_)
+        worker->thread = std::thread([this, &w = *worker] { work(w); });
+}
+
+AnalysisPool::~AnalysisPool() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+    jobs_.clear();
+    ready_.notify_all();
+
+    // A search that was just taken off the queue clears its stop flags as
+    // it starts, so a single stop() could be lost; keep stopping the busy
+    // ones until they are all done
+    for (;;) {
+        bool busy = false;
+        for (auto& worker : workers_) {
+            if (worker->busy) {
+                worker->search->stop();
+                busy = true;
+            }
+        }
+        if (!busy)
+            break;
+        idle_.wait_for(lock, std::chrono::milliseconds(1));
+    }
+    lock.unlock();
+
+    for (auto& worker : workers_)
+        worker->thread.join();
+}
+
+bool AnalysisPool::submit(const ChessBoard& board, const SearchLimits& limits,
+                          Done done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || jobs_.size() >= maxQueued_)
+            return false;
+        jobs_.push_back({ board, limits, std::move(done) });
+    }
+    ready_.notify_one();
+    return true;
+}
+
+std::size_t AnalysisPool::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void AnalysisPool::work(Worker& worker) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (stopping_)
+            return;
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        worker.busy = true;
+        lock.unlock();
+
+        SearchResult result = worker.search->run(job.board, job.limits);
+
+        lock.lock();
+        worker.busy = false;
+        bool report = !stopping_;
+        idle_.notify_all();
+
+        if (report) {
+            lock.unlock();
+            job.done(result);
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef ANALYSIS_POOL_HPP
+#define ANALYSIS_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel_search.hpp"
+
+/* ---------------- AnalysisPool ---------------- */
+
+/*
+ * A fixed number of searches shared by everyone who asks for one. Each
+ * worker thread owns a ParallelSearch of `threadsPerSearch` threads, so
+ * no more than workers * threadsPerSearch threads ever search at once,
+ * however many requests come in. Requests wait in a bounded queue;
+ * submit() refuses one when the queue is full.
+ *
+ * The destructor drops what is queued, stops the searches under way and
+ * joins every thread; nothing is reported after that.
+ */
+class AnalysisPool {
+public:
+    // Called on the worker thread with the result
+    using Done = std::function<void(const SearchResult&)>;
+
+    AnalysisPool(TranspositionTable& table, int workers, int threadsPerSearch,
+                 std::size_t maxQueued);
+    ~AnalysisPool();
+
+    AnalysisPool(const AnalysisPool&) = delete;
+    AnalysisPool& operator=(const AnalysisPool&) = delete;
+
+    // Queues a search of `board`; false, and `done` is never called, if
+    // the queue is full
+    bool submit(const ChessBoard& board, const SearchLimits& limits, Done done);
+
+    int workers() const { return static_cast<int>(workers_.size()); }
+
+    // Requests waiting for a worker
+    std::size_t queued() const;
+
+private:
+    struct Job {
+        ChessBoard board;
+        SearchLimits limits;
+        Done done;
+    };
+
+    struct Worker {
+        std::unique_ptr<ParallelSearch> search;
+        std::thread thread;
+        bool busy = false;
+    };
+
+    void work(Worker& worker);
+
+    std::size_t maxQueued_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_; // a job was queued, or stopping
+    std::condition_variable idle_;  // a worker finished a search
+    std::deque<Job> jobs_;
+    bool stopping_ = false;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "evaluation.hpp"
+
+/*
+ * Material plus piece-square tables (the "simplified evaluation function").
+ * Tables are laid out as seen from White with A8 first, which matches the
+ * board's square numbering; Black reads them mirrored (sq ^ 56).
+ * The king blends between middlegame and endgame tables by game phase.
+ */
+namespace {
+
+const int kPawnTable[64] = {
+     0,  0,  0,  0,  0,  0,  0,  0,
+    50, 50, 50, 50, 50, 50, 50, 50,
+    10, 10, 20, 30, 30, 20, 10, 10,
+     5,  5, 10, 25, 25, 10,  5,  5,
+     0,  0,  0, 20, 20,  0,  0,  0,
+     5, -5,-10,  0,  0,-10, -5,  5,
+     5, 10, 10,-20,-20, 10, 10,  5,
+     0,  0,  0,  0,  0,  0,  0,  0
+};
+
+const int kKnightTable[64] = {
+   -50,-40,-30,-30,-30,-30,-40,-50,
+   -40,-20,  0,  0,  0,  0,-20,-40,
+   -30,  0, 10, 15, 15, 10,  0,-30,
+   -30,  5, 15, 20, 20, 15,  5,-30,
+   -30,  0, 15, 20, 20, 15,  0,-30,
+   -30,  5, 10, 15, 15, 10,  5,-30,
+   -40,-20,  0,  5,  5,  0,-20,-40,
+   -50,-40,-30,-30,-30,-30,-40,-50
+};
+
+const int kBishopTable[64] = {
+   -20,-10,-10,-10,-10,-10,-10,-20,
+   -10,  0,  0,  0,  0,  0,  0,-10,
+   -10,  0,  5, 10, 10,  5,  0,-10,
+   -10,  5,  5, 10, 10,  5,  5,-10,
+   -10,  0, 10, 10, 10, 10,  0,-10,
+   -10, 10, 10, 10, 10, 10, 10,-10,
+   -10,  5,  0,  0,  0,  0,  5,-10,
+   -20,-10,-10,-10,-10,-10,-10,-20
+};
+
+const int kRookTable[64] = {
+     0,  0,  0,  0,  0,  0,  0,  0,
+     5, 10, 10, 10, 10, 10, 10,  5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+     0,  0,  0,  5,  5,  0,  0,  0
+};
+
+const int kQueenTable[64] = {
+   -20,-10,-10, -5, -5,-10,-10,-20,
+   -10,  0,  0,  0,  0,  0,  0,-10,
+   -10,  0,  5,  5,  5,  5,  0,-10,
+    -5,  0,  5,  5,  5,  5,  0, -5,
+     0,  0,  5,  5,  5,  5,  0, -5,
+   -10,  5,  5,  5,  5,  5,  0,-10,
+   -10,  0,  5,  0,  0,  0,  0,-10,
+   -20,-10,-10, -5, -5,-10,-10,-20
+};
+
+const int kKingMiddleTable[64] = {
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -20,-30,-30,-40,-40,-30,-30,-20,
+   -10,-20,-20,-20,-20,-20,-20,-10,
+    20, 20,  0,  0,  0,  0, 20, 20,
+    20, 30, 10,  0,  0, 10, 30, 20
+};
+
+const int kKingEndTable[64] = {
+   -50,-40,-30,-20,-20,-30,-40,-50,
+   -30,-20,-10,  0,  0,-10,-20,-30,
+   -30,-10, 20, 30, 30, 20,-10,-30,
+   -30,-10, 30, 40, 40, 30,-10,-30,
+   -30,-10, 30, 40, 40, 30,-10,-30,
+   -30,-10, 20, 30, 30, 20,-10,-30,
+   -30,-30,  0,  0,  0,  0,-30,-30,
+   -50,-30,-30,-30,-30,-30,-30,-50
+};
+
+// Indexed by PieceType (Pawn, Rook, Knight, Bishop, Queen; king handled apart)
+const int* const kTables[5] = {
+    kPawnTable, kRookTable, kKnightTable, kBishopTable, kQueenTable
+};
+
+// Contribution of each piece type to the game phase (24 = all pieces on)
+const int kPhaseWeight[6] = { 0, 2, 1, 1, 4, 0 };
+constexpr int kMaxPhase = 24;
+
+} // namespace
+
+int evaluate(const ChessBoard& board) {
+    int score[2] = { 0, 0 };
+    int phase = 0;
+
+    for (Color color : { Color::White, Color::Black }) {
+        int c = colorIndex(color);
+        int mirror = (color == Color::White) ? 0 : 56;
+
+        for (int t = 0; t < 5; ++t) {
+            PieceType type = static_cast<PieceType>(t);
+            for (Bitboard b = board.pieces(color, type); b; ) {
+                int sq = popLsb(b);
+                score[c] += kPieceValue[t] + kTables[t][sq ^ mirror];
+                phase += kPhaseWeight[t];
+            }
+        }
+    }
+
+    // King: blend the two tables by how much material is left
+    if (phase > kMaxPhase)
+        phase = kMaxPhase;
+
+    for (Color color : { Color::White, Color::Black }) {
+        Bitboard king = board.pieces(color, PieceType::King);
+        if (!king)
+            continue;
+
+        int sq = lsb(king) ^ ((color == Color::White) ? 0 : 56);
+        score[colorIndex(color)] +=
+            (kKingMiddleTable[sq] * phase +
+             kKingEndTable[sq] * (kMaxPhase - phase)) / kMaxPhase;
+    }
+
+    int white = score[colorIndex(Color::White)] - score[colorIndex(Color::Black)];
+    return board.sideToMove() == Color::White ? white : -white;
+}
@@ -0,0 +1,12 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include "chess/chess_board.hpp"
+
+// Material values in centipawns, indexed by PieceType
+constexpr int kPieceValue[6] = { 100, 500, 320, 330, 900, 20000 };
+
+// Static score in centipawns from the side to move's point of view
+int evaluate(const ChessBoard& board);
+
+#endif
@@ -0,0 +1,252 @@
+#include "opening_book.hpp"
+
+#include "chess/pgn.hpp"
+#include "polyglot_random.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+// Moves seen before the builder sorts and merges them again
+constexpr std::size_t kCompactEvery = 1 << 20;
+
+std::uint64_t readBig(const unsigned char* at, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+        value = (value << 8) | at[i];
+    return value;
+}
+
+void writeBig(char* at, std::uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i, value >>= 8)
+        at[i] = static_cast<char>(value & 0xFF);
+}
+
+// Polyglot ranks count up from White's side; board rows count down
+int bookSquare(int square) {
+    return (7 - squareY(square)) * 8 + squareX(square);
+}
+
+// Polyglot's piece kinds go pawn, knight, bishop, rook, queen, king
+int bookKind(PieceType type) {
+    static constexpr int kKinds[] = { 0, 3, 1, 2, 4, 5 }; // by typeIndex()
+    return kKinds[typeIndex(type)];
+}
+
+} // namespace
+
+/* ---------------- OpeningBook ---------------- */
+
+OpeningBook::OpeningBook(const std::string& path)
+    : file_(path, MappedFile::Access::Random) {
+    if (file_.size() % kEntrySize != 0)
+        throw std::runtime_error(path + " is not an opening book (" +
+                                 std::to_string(file_.size()) + " bytes)");
+}
+
+std::uint16_t OpeningBook::encode(Move move) {
+    int from = move.from();
+    int to = move.to();
+
+    // The king's destination becomes the square of the rook it castles with
+    if (move.flag() == Move::Castle)
+        to = makeSquare(squareX(to) == 6 ? 7 : 0, squareY(to));
+
+    int promotion = move.isPromotion() ? move.flag() - Move::PromoKnight + 1 : 0;
+    return static_cast<std::uint16_t>(bookSquare(to) | (bookSquare(from) << 6) |
+                                      (promotion << 12));
+}
+
+std::uint64_t OpeningBook::key(const ChessBoard& board) {
+    BoardSnapshot position = board.snapshot();
+    std::uint64_t key = 0;
+
+    for (PieceType type : { PieceType::Pawn, PieceType::Rook, PieceType::Knight,
+                            PieceType::Bishop, PieceType::Queen, PieceType::King }) {
+        for (Color color : { Color::White, Color::Black }) {
+            int kind = 2 * bookKind(type) + (color == Color::White ? 1 : 0);
+            Bitboard squares = position.pieces[typeIndex(type)] &
+                               position.colors[colorIndex(color)];
+            while (squares)
+                key ^= polyglot::kRandom[64 * kind + bookSquare(popLsb(squares))];
+        }
+    }
+
+    // The board's rights bits are in Polyglot's order
+    for (int right = 0; right < 4; ++right)
+        if (position.castlingRights & (1 << right))
+            key ^= polyglot::kRandom[polyglot::kCastlingKeys + right];
+
+    // The board only keeps an en-passant square a pawn can take on, which
+    // is when Polyglot counts it
+    if (position.enPassantSquare >= 0)
+        key ^= polyglot::kRandom[polyglot::kEnPassantKeys + squareX(position.enPassantSquare)];
+
+    if (position.side() == Color::White)
+        key ^= polyglot::kRandom[polyglot::kWhiteToMoveKey];
+    return key;
+}
+
+std::size_t OpeningBook::lookup(const ChessBoard& board, Moves& moves) const {
+    const auto* data = reinterpret_cast<const unsigned char*>(file_.data());
+    const std::uint64_t key = OpeningBook::key(board);
+    const std::size_t count = entries();
+
+    // First entry with this key
+    std::size_t low = 0, high = count;
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (readBig(data + middle * kEntrySize, 8) < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == count || readBig(data + low * kEntrySize, 8) != key)
+        return 0;
+
+    MoveList legal;
+    board.generateLegalMoves(legal);
+
+    std::size_t found = 0;
+    for (std::size_t i = low; i < count && found < kMaxMoves; ++i) {
+        const unsigned char* entry = data + i * kEntrySize;
+        if (readBig(entry, 8) != key)
+            break;
+        auto raw = static_cast<std::uint16_t>(readBig(entry + 8, 2));
+        auto weight = static_cast<std::uint16_t>(readBig(entry + 10, 2));
+        for (Move move : legal) {
+            if (encode(move) == raw) {
+                moves[found++] = { move, weight };
+                break;
+            }
+        }
+    }
+
+    std::stable_sort(moves.begin(), moves.begin() + static_cast<std::ptrdiff_t>(found),
+                     [](const BookMove& a, const BookMove& b) { return a.weight > b.weight; });
+    return found;
+}
+
+Move OpeningBook::pick(const ChessBoard& board, std::uint64_t random) const {
+    Moves moves;
+    std::size_t count = lookup(board, moves);
+
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        total += moves[i].weight;
+    if (total == 0)
+        return count > 0 ? moves[0].move : Move();
+
+    std::uint64_t at = random % total;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (at < moves[i].weight)
+            return moves[i].move;
+        at -= moves[i].weight;
+    }
+    return moves[0].move;
+}
+
+/* ---------------- BookBuilder ---------------- */
+
+BookBuilder::BookBuilder(int plies) : plies_(plies) {}
+
+bool BookBuilder::addGame(const PgnGame& game, ChessBoard& board) {
+    std::string_view fen = game.tag("FEN");
+    if (fen.empty())
+        board.initialize();
+    else if (!board.fromFEN(fen))
+        return false;
+
+    // Scores for White's moves and Black's, from the Result tag
+    std::string_view result = game.tag("Result");
+    std::uint32_t white = 1, black = 1;
+    if (result == "1-0")
+        white = 2, black = 0;
+    else if (result == "0-1")
+        white = 0, black = 2;
+
+    const std::size_t before = seen_.size();
+    PgnMoves moves(game.movetext);
+    std::string_view san;
+    for (int ply = 0; ply < plies_ && moves.next(san); ++ply) {
+        Move move = board.fromSAN(san);
+        if (move.isNull()) {
+            seen_.resize(before);
+            return false;
+        }
+        std::uint32_t score = board.sideToMove() == Color::White ? white : black;
+        seen_.push_back({ OpeningBook::key(board), OpeningBook::encode(move), score, 1 });
+        board.playMove(move);
+    }
+
+    ++games_;
+    if (seen_.size() - compacted_ >= kCompactEvery)
+        compact();
+    return true;
+}
+
+void BookBuilder::compact() {
+    auto byPosition = [](const Seen& a, const Seen& b) {
+        return a.key != b.key ? a.key < b.key : a.move < b.move;
+    };
+    auto middle = seen_.begin() + static_cast<std::ptrdiff_t>(compacted_);
+    std::sort(middle, seen_.end(), byPosition);
+    std::inplace_merge(seen_.begin(), middle, seen_.end(), byPosition);
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < seen_.size(); ++i) {
+        if (kept > 0 && seen_[kept - 1].key == seen_[i].key &&
+            seen_[kept - 1].move == seen_[i].move) {
+            seen_[kept - 1].score += seen_[i].score;
+            seen_[kept - 1].games += seen_[i].games;
+        }
+        else {
+            seen_[kept++] = seen_[i];
+        }
+    }
+    seen_.resize(kept);
+    seen_.shrink_to_fit();
+    compacted_ = kept;
+}
+
+std::size_t BookBuilder::write(const std::string& path, int minGames) {
+    compact();
+
+    std::vector<Seen> book;
+    std::uint32_t highest = 0;
+    for (const Seen& seen : seen_) {
+        if (seen.score == 0 || seen.games < static_cast<std::uint32_t>(std::max(minGames, 1)))
+            continue;
+        book.push_back(seen);
+        highest = std::max(highest, seen.score);
+    }
+
+    // Weights are 16 bits; keep their proportions, and every kept move above 0
+    for (Seen& seen : book) {
+        if (highest > 0xFFFF)
+            seen.score = std::max<std::uint32_t>(
+                1, static_cast<std::uint32_t>(std::uint64_t(seen.score) * 0xFFFF / highest));
+    }
+    std::stable_sort(book.begin(), book.end(), [](const Seen& a, const Seen& b) {
+        return a.key != b.key ? a.key < b.key : a.score > b.score;
+    });
+
+    std::vector<char> bytes(book.size() * OpeningBook::kEntrySize, 0);
+    for (std::size_t i = 0; i < book.size(); ++i) {
+        char* entry = bytes.data() + i * OpeningBook::kEntrySize;
+        writeBig(entry, book[i].key, 8);
+        writeBig(entry + 8, book[i].move, 2);
+        writeBig(entry + 10, book[i].score, 2);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    if (!out)
+        throw std::runtime_error("cannot write " + path + ": " + std::strerror(errno));
+    return book.size();
+}
@@ -0,0 +1,121 @@
+#ifndef OPENING_BOOK_HPP
+#define OPENING_BOOK_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "chess/chess_board.hpp"
+#include "chess/mapped_file.hpp"
+
+struct PgnGame;
+
+/*
+ * Book files use the Polyglot layout: 16-byte entries, sorted by key,
+ * each made of
+ *   bytes  0-7   position key
+ *   bytes  8-9   move
+ *   bytes 10-11  weight (relative to the other moves of the position)
+ *   bytes 12-15  learning data (unused, written as 0)
+ * all big-endian. A move packs to file, to rank, from file, from rank
+ * and promotion into 3 bits each, lowest first, with ranks counted from
+ * White's side and promotion 0 for none, then knight to queen. Castling
+ * is written as the king taking its own rook (e1h1).
+ *
+ * Keys are Polyglot's own (OpeningBook::key()), so books made by other
+ * Polyglot tools read as they are, and books made here work with them.
+ */
+
+struct BookMove {
+    Move move;
+    std::uint16_t weight = 0;
+};
+
+/* ---------------- OpeningBook ---------------- */
+
+/*
+ * A book file, memory-mapped and searched in place. A lookup is a binary
+ * search on the keys, touching a handful of pages, and then one pass over
+ * the position's legal moves; nothing is allocated and nothing is locked,
+ * so one book serves every thread.
+ */
+class OpeningBook {
+public:
+    static constexpr std::size_t kEntrySize = 16;
+    static constexpr std::size_t kMaxMoves = 32; // per position; more are ignored
+
+    using Moves = std::array<BookMove, kMaxMoves>;
+
+    // Throws std::runtime_error if the file cannot be mapped or is not
+    // made of whole entries
+    explicit OpeningBook(const std::string& path);
+
+    // The book's moves for the position, heaviest first, into `moves`.
+    // Returns how many; 0 if the position is not in the book. Entries that
+    // are not legal moves in the position are skipped.
+    std::size_t lookup(const ChessBoard& board, Moves& moves) const;
+
+    // One of the book's moves, chosen in proportion to its weight by
+    // `random` (any 64-bit number); a null Move if the position is not in
+    // the book
+    Move pick(const ChessBoard& board, std::uint64_t random) const;
+
+    std::size_t entries() const { return file_.size() / kEntrySize; }
+
+    // The 16-bit book form of a move
+    static std::uint16_t encode(Move move);
+
+    // The Polyglot key of a position: the XOR of the random numbers for
+    // each piece, each castling right, the en-passant file when a pawn
+    // can take there, and White to move (polyglot_random.hpp)
+    static std::uint64_t key(const ChessBoard& board);
+
+private:
+    MappedFile file_;
+};
+
+/* ---------------- BookBuilder ---------------- */
+
+/*
+ * Makes a book from games. Each move in the first `plies` of a game
+ * scores 2 if the side that played it went on to win, 1 for a draw or an
+ * unfinished game, and 0 for a loss; a move's weight is its total score,
+ * scaled down to fit 16 bits if need be. Games are read one at a time and
+ * only what the book will hold is kept.
+ */
+class BookBuilder {
+public:
+    explicit BookBuilder(int plies = 16);
+
+    // Adds the opening of a game, replaying it on `board`. Returns false,
+    // and adds nothing, if its FEN or one of its first moves does not play.
+    bool addGame(const PgnGame& game, ChessBoard& board);
+
+    // Writes the book to `path`, leaving out moves played in fewer than
+    // `minGames` games and moves that never scored. Returns the number of
+    // entries written. Throws std::runtime_error if the file cannot be
+    // written.
+    std::size_t write(const std::string& path, int minGames = 1);
+
+    std::size_t games() const { return games_; }
+
+private:
+    struct Seen {
+        std::uint64_t key;
+        std::uint16_t move;     // book form
+        std::uint32_t score;
+        std::uint32_t games;
+    };
+
+    // Sorts the moves seen so far and merges repeats
+    void compact();
+
+    int plies_;
+    std::size_t games_ = 0;
+    std::vector<Seen> seen_;
+    std::size_t compacted_ = 0; // seen_[0, compacted_) is sorted and merged
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "parallel_search.hpp"
+
+#include <algorithm>
+#include <thread>
+
+ParallelSearch::ParallelSearch(TranspositionTable& table, int threads)
+    : table_(table) {
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; ++i)
+        searchers_.push_back(std::make_unique<Search>(table, i));
+}
+
+void ParallelSearch::stop() {
+    for (auto& searcher : searchers_)
+        searcher->stop();
+}
+
+SearchResult ParallelSearch::run(const ChessBoard& board,
+                                 const SearchLimits& limits) {
+    table_.newSearch();
+
+    // Clear every stop flag before any thread starts, so stopping the
+    // helpers below can never be lost to a helper that starts late
+    for (auto& searcher : searchers_)
+        searcher->stopped_.store(false, std::memory_order_relaxed);
+
+    // Helpers only stop when told to; the main thread owns the limits
+    SearchLimits helperLimits;
+    helperLimits.maxDepth = limits.maxDepth;
+
+    std::vector<SearchResult> results(searchers_.size());
+    std::vector<std::thread> helpers;
+    helpers.reserve(searchers_.size() - 1);
+
+    for (std::size_t i = 1; i < searchers_.size(); ++i) {
+        helpers.emplace_back([this, i, &board, &helperLimits, &results] {
+            results[i] = searchers_[i]->iterate(board, helperLimits);
+        });
+    }
+
+    results[0] = searchers_[0]->iterate(board, limits);
+
+    stop();
+    for (std::thread& helper : helpers)
+        helper.join();
+
+    // Prefer the deepest completed iteration; ties go to the main thread
+    SearchResult best = results[0];
+    std::uint64_t nodes = 0, hits = 0, misses = 0, evictions = 0;
+
+    for (const SearchResult& result : results) {
+        nodes += result.nodes;
+        hits += result.tableHits;
+        misses += result.tableMisses;
+        evictions += result.tableEvictions;
+        if (result.depth > best.depth && !result.bestMove.isNull())
+            best = result;
+    }
+
+    best.nodes = nodes;
+    best.tableHits = hits;
+    best.tableMisses = misses;
+    best.tableEvictions = evictions;
+    best.seconds = results[0].seconds;
+    best.nps = best.seconds > 0
+        ? static_cast<std::uint64_t>(nodes / best.seconds)
+        : 0;
+    return best;
+}
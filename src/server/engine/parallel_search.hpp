@@ -0,0 +1,40 @@
+#ifndef PARALLEL_SEARCH_HPP
+#define PARALLEL_SEARCH_HPP
+
+#include <memory>
+#include <vector>
+
+#include "search.hpp"
+
+/* ---------------- ParallelSearch ---------------- */
+
+/*
+ * Lazy SMP: every thread runs an ordinary Search of the same position and
+ * they cooperate only through the shared TranspositionTable. Helpers
+ * skip some depths, so they run ahead of the main thread and fill the table
+ * with results that the main thread then gets as cutoffs.
+ *
+ * The calling thread is the main thread and decides when to stop (its
+ * time, node and depth limits apply); the helpers are stopped when it
+ * returns. The reported move comes from whichever thread finished the
+ * deepest iteration. Nodes and table counts are summed over all threads.
+ */
+class ParallelSearch {
+public:
+    ParallelSearch(TranspositionTable& table, int threads);
+
+    SearchResult run(const ChessBoard& board, const SearchLimits& limits);
+
+    // Safe to call from another thread
+    void stop();
+
+    int threads() const { return static_cast<int>(searchers_.size()); }
+
+private:
+    TranspositionTable& table_;
+
+    // Heap allocated: each Search carries its own killer and history tables
+    std::vector<std::unique_ptr<Search>> searchers_;
+};
+
+#endif
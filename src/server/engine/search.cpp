@@ -0,0 +1,412 @@
+#include "search.hpp"
+#include "evaluation.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+// Move ordering tiers
+constexpr int kHashMoveScore = 1000000;
+constexpr int kCaptureScore  = 100000;
+constexpr int kKillerScore   = 90000;
+constexpr int kHistoryMax    = 50000;
+
+// Check the clock every this many nodes
+constexpr std::uint64_t kCheckInterval = 2048;
+
+// Lazy SMP: helper i skips an iteration when
+// ((depth + kSkipPhase[i]) / kSkipSize[i]) is odd
+constexpr int kSkipSize[]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                               3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+constexpr int kSkipPhase[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                               4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+constexpr int kSkipPatterns = sizeof(kSkipSize) / sizeof(kSkipSize[0]);
+
+PieceType pieceTypeOn(const ChessBoard& board, int sq) {
+    return board.getPiece(squareX(sq), squareY(sq))->getType();
+}
+
+// Mate scores are stored relative to the node, not the root
+int scoreToTable(int score, int ply) {
+    if (score >= kMateBound) return score + ply;
+    if (score <= -kMateBound) return score - ply;
+    return score;
+}
+
+int scoreFromTable(int score, int ply) {
+    if (score >= kMateBound) return score - ply;
+    if (score <= -kMateBound) return score + ply;
+    return score;
+}
+
+// Moves the best-scored remaining move to position i
+void pickMove(MoveList& moves, int* scores, std::size_t i) {
+    std::size_t best = i;
+    for (std::size_t j = i + 1; j < moves.size(); ++j)
+        if (scores[j] > scores[best])
+            best = j;
+    std::swap(moves[i], moves[best]);
+    std::swap(scores[i], scores[best]);
+}
+
+} // namespace
+
+/* ---------------- SearchResult ---------------- */
+
+std::string SearchResult::summary() const {
+    std::ostringstream out;
+    out << "depth " << depth
+        << " nodes " << nodes
+        << " nps " << nps
+        << " score ";
+
+    if (score >= kMateBound)
+        out << "mate " << (kMateScore - score + 1) / 2;
+    else if (score <= -kMateBound)
+        out << "mate -" << (kMateScore + score) / 2;
+    else
+        out << "cp " << score;
+
+    out << " best " << (bestMove.isNull() ? "none" : bestMove.toString());
+    if (!pv.empty())
+        out << " pv " << pv;
+    return out.str();
+}
+
+/* ---------------- Search ---------------- */
+
+Search::Search(TranspositionTable& table, int threadIndex)
+    : table_(table), threadIndex_(threadIndex) {}
+
+SearchResult Search::run(const ChessBoard& board, const SearchLimits& limits) {
+    stopped_.store(false, std::memory_order_relaxed);
+    return iterate(board, limits);
+}
+
+bool Search::skipsDepth(int depth) const {
+    // The main thread and the first iteration are never skipped
+    if (threadIndex_ == 0 || depth == 1)
+        return false;
+
+    int i = (threadIndex_ - 1) % kSkipPatterns;
+    return ((depth + kSkipPhase[i]) / kSkipSize[i]) % 2 != 0;
+}
+
+SearchResult Search::iterate(const ChessBoard& board, const SearchLimits& limits) {
+    board_ = board;
+    limits_ = limits;
+    nodes_ = 0;
+    tableHits_ = tableMisses_ = tableEvictions_ = 0;
+    start_ = Clock::now();
+
+    for (auto& killers : killers_)
+        killers[0] = killers[1] = Move();
+    std::memset(history_, 0, sizeof(history_));
+
+    SearchResult result;
+
+    MoveList rootMoves;
+    board_.generateLegalMoves(rootMoves);
+    if (rootMoves.empty()) {
+        result.score = board_.isKingInCheck(board_.sideToMove()) ? -kMateScore : 0;
+        return result;
+    }
+    result.bestMove = rootMoves[0];
+
+    int maxDepth = std::min(limits_.maxDepth, ChessBoard::kMaxPly - 1);
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        if (skipsDepth(depth))
+            continue;
+
+        rootBest_ = Move();
+        int score = negamax(depth, -kInfinity, kInfinity, 0);
+
+        // An interrupted iteration is incomplete; keep the previous answer
+        if (stopped_.load(std::memory_order_relaxed) && depth > 1)
+            break;
+
+        result.depth = depth;
+        result.score = score;
+        if (!rootBest_.isNull())
+            result.bestMove = rootBest_;
+
+        if (stopped_.load(std::memory_order_relaxed))
+            break;
+
+        // A forced mate will not get any shorter by searching deeper
+        if (std::abs(score) >= kMateBound)
+            break;
+
+        // The next iteration costs more than all previous ones together
+        if (limits_.time.count() > 0 &&
+            Clock::now() - start_ > limits_.time / 2)
+            break;
+    }
+
+    result.nodes = nodes_;
+    result.tableHits = tableHits_;
+    result.tableMisses = tableMisses_;
+    result.tableEvictions = tableEvictions_;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start_).count();
+    result.nps = result.seconds > 0
+        ? static_cast<std::uint64_t>(nodes_ / result.seconds)
+        : 0;
+    result.pv = principalVariation(result.depth);
+    return result;
+}
+
+void Search::checkLimits() {
+    if (limits_.nodes && nodes_ >= limits_.nodes)
+        stop();
+
+    if (limits_.time.count() > 0 && Clock::now() - start_ >= limits_.time)
+        stop();
+}
+
+/* ---------------- Alpha-beta ---------------- */
+
+int Search::negamax(int depth, int alpha, int beta, int ply) {
+    if (depth <= 0)
+        return quiescence(alpha, beta, ply);
+
+    if (++nodes_ % kCheckInterval == 0)
+        checkLimits();
+    if (stopped_.load(std::memory_order_relaxed))
+        return 0;
+
+    if (ply > 0 && board_.isRepetition())
+        return 0;
+    if (board_.ply() >= ChessBoard::kMaxPly - 1)
+        return evaluate(board_);
+
+    Color us = board_.sideToMove();
+    bool inCheck = board_.isKingInCheck(us);
+
+    // Check extension: never stop searching right in the middle of a check
+    if (inCheck)
+        ++depth;
+
+    /* ---- Transposition table ---- */
+    std::uint64_t key = board_.hash();
+    TTEntry entry;
+    Move hashMove;
+
+    if (!table_.probe(key, entry)) {
+        ++tableMisses_;
+    }
+    else {
+        ++tableHits_;
+        hashMove = entry.move;
+
+        if (ply > 0 && entry.depth >= depth && entry.bound != Bound::None) {
+            int score = scoreFromTable(entry.score, ply);
+            if (entry.bound == Bound::Exact ||
+                (entry.bound == Bound::Lower && score >= beta) ||
+                (entry.bound == Bound::Upper && score <= alpha))
+                return score;
+        }
+    }
+
+    /* ---- Moves ---- */
+    MoveList moves;
+    board_.generateLegalMoves(moves);
+
+    if (moves.empty())
+        return inCheck ? -kMateScore + ply : 0;
+
+    int scores[MoveList::kCapacity];
+    scoreMoves(moves, scores, hashMove, ply);
+
+    int alphaOrig = alpha;
+    int bestScore = -kInfinity;
+    Move bestMove;
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        pickMove(moves, scores, i);
+        Move move = moves[i];
+        bool quiet = !isCapture(move) && !move.isPromotion();
+
+        board_.makeMove(move);
+
+        // Principal variation search: prove later moves are worse with a
+        // zero window, and only re-search the ones that are not
+        int score;
+        if (i == 0) {
+            score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            score = -negamax(depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta)
+                score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+        }
+
+        board_.unmakeMove();
+
+        if (stopped_.load(std::memory_order_relaxed))
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (ply == 0)
+                rootBest_ = move;
+        }
+
+        if (score > alpha)
+            alpha = score;
+
+        if (alpha >= beta) {
+            if (quiet)
+                updateQuietStats(move, depth, ply);
+            break;
+        }
+    }
+
+    Bound bound = bestScore >= beta    ? Bound::Lower
+                : bestScore > alphaOrig ? Bound::Exact
+                                        : Bound::Upper;
+    if (table_.store(key, bestMove, scoreToTable(bestScore, ply), depth, bound))
+        ++tableEvictions_;
+
+    return bestScore;
+}
+
+int Search::quiescence(int alpha, int beta, int ply) {
+    if (++nodes_ % kCheckInterval == 0)
+        checkLimits();
+    if (stopped_.load(std::memory_order_relaxed))
+        return 0;
+
+    // Stand pat: the side to move can usually do at least this well
+    int standPat = evaluate(board_);
+    if (standPat >= beta)
+        return standPat;
+    if (standPat > alpha)
+        alpha = standPat;
+
+    if (board_.ply() >= ChessBoard::kMaxPly - 1)
+        return standPat;
+
+    MoveList all;
+    board_.generateLegalMoves(all);
+
+    // Only captures and promotions are searched here
+    MoveList moves;
+    for (Move move : all)
+        if (isCapture(move) || move.isPromotion())
+            moves.push_back(move);
+
+    int scores[MoveList::kCapacity];
+    scoreMoves(moves, scores, Move(), ply);
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        pickMove(moves, scores, i);
+
+        board_.makeMove(moves[i]);
+        int score = -quiescence(-beta, -alpha, ply + 1);
+        board_.unmakeMove();
+
+        if (stopped_.load(std::memory_order_relaxed))
+            return 0;
+
+        if (score >= beta)
+            return score;
+        if (score > alpha)
+            alpha = score;
+    }
+
+    return alpha;
+}
+
+/* ---------------- Move ordering ---------------- */
+
+bool Search::isCapture(Move move) const {
+    return move.flag() == Move::EnPassant ||
+           board_.getPiece(squareX(move.to()), squareY(move.to())) != nullptr;
+}
+
+void Search::scoreMoves(const MoveList& moves, int* scores,
+                        Move hashMove, int ply) const {
+    int side = colorIndex(board_.sideToMove());
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        Move move = moves[i];
+
+        if (move == hashMove) {
+            scores[i] = kHashMoveScore;
+        } else if (isCapture(move) || move.isPromotion()) {
+            // MVV-LVA: most valuable victim first, cheapest attacker first
+            int victim = 0;
+            if (move.flag() == Move::EnPassant)
+                victim = kPieceValue[typeIndex(PieceType::Pawn)];
+            else if (isCapture(move))
+                victim = kPieceValue[typeIndex(pieceTypeOn(board_, move.to()))];
+            if (move.isPromotion())
+                victim += kPieceValue[typeIndex(move.promotion())];
+
+            int attacker = kPieceValue[typeIndex(pieceTypeOn(board_, move.from()))];
+            scores[i] = kCaptureScore + victim * 10 - attacker / 100;
+        } else if (move == killers_[ply][0]) {
+            scores[i] = kKillerScore;
+        } else if (move == killers_[ply][1]) {
+            scores[i] = kKillerScore - 1;
+        } else {
+            scores[i] = history_[side][move.from()][move.to()];
+        }
+    }
+}
+
+void Search::updateQuietStats(Move move, int depth, int ply) {
+    if (killers_[ply][0] != move) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = move;
+    }
+
+    int side = colorIndex(board_.sideToMove());
+    int& h = history_[side][move.from()][move.to()];
+    h += depth * depth;
+
+    // Keep history below the killer tier by halving everything
+    if (h >= kHistoryMax) {
+        for (auto& from : history_[side])
+            for (int& value : from)
+                value /= 2;
+    }
+}
+
+/* ---------------- Principal variation ---------------- */
+
+std::string Search::principalVariation(int maxLength) {
+    std::string pv;
+    int played = 0;
+
+    // Follow hash moves from the root while they are still legal
+    while (played < maxLength) {
+        TTEntry entry;
+        if (!table_.probe(board_.hash(), entry) || entry.move.isNull())
+            break;
+
+        MoveList moves;
+        board_.generateLegalMoves(moves);
+        if (std::find(moves.begin(), moves.end(), entry.move) == moves.end())
+            break;
+
+        if (!pv.empty())
+            pv += ' ';
+        pv += entry.move.toString();
+
+        board_.makeMove(entry.move);
+        ++played;
+
+        if (board_.isRepetition())
+            break;
+    }
+
+    while (played-- > 0)
+        board_.unmakeMove();
+
+    return pv;
+}
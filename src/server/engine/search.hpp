@@ -0,0 +1,108 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "chess/chess_board.hpp"
+#include "transposition_table.hpp"
+
+/* ---------------- Scores ---------------- */
+
+constexpr int kInfinity  = 32000;
+constexpr int kMateScore = 31000;
+
+// Scores beyond this are "mate in N"
+constexpr int kMateBound = kMateScore - ChessBoard::kMaxPly;
+
+/* ---------------- Limits / Result ---------------- */
+
+struct SearchLimits {
+    int maxDepth = 64;
+    std::chrono::milliseconds time{ 0 }; // 0 = no time limit
+    std::uint64_t nodes = 0;             // 0 = no node limit
+};
+
+struct SearchResult {
+    Move bestMove;
+    int score = 0;       // centipawns, side to move's point of view
+    int depth = 0;       // last fully searched depth
+    std::uint64_t nodes = 0;
+    double seconds = 0;
+    std::uint64_t nps = 0;
+    std::string pv;      // principal variation, coordinate notation
+
+    // Transposition table use: probes that found the position and probes
+    // that did not, and stores that pushed another position out
+    std::uint64_t tableHits = 0;
+    std::uint64_t tableMisses = 0;
+    std::uint64_t tableEvictions = 0;
+
+    // "depth 9 nodes 123456 nps 1000000 score cp 35 best e2e4 pv e2e4 e7e5"
+    std::string summary() const;
+};
+
+/* ---------------- Search ---------------- */
+
+/*
+ * Iterative-deepening negamax alpha-beta with quiescence search.
+ * Moves are ordered hash move first, then captures by MVV-LVA, then
+ * killer moves, then quiet moves by history score. The board is walked
+ * with makeMove()/unmakeMove(), so a search never allocates.
+ *
+ * One Search object searches on one thread; any number of them can share
+ * a TranspositionTable. The caller ages the table (newSearch()) once per
+ * search, so several threads searching together do not age it N times.
+ *
+ * threadIndex > 0 marks a Lazy SMP helper (see ParallelSearch): it skips
+ * some iterations so the threads spread out over different depths
+ * instead of all searching the same tree in lockstep.
+ */
+class Search {
+public:
+    explicit Search(TranspositionTable& table, int threadIndex = 0);
+
+    SearchResult run(const ChessBoard& board, const SearchLimits& limits);
+
+    // Safe to call from another thread
+    void stop() { stopped_.store(true, std::memory_order_relaxed); }
+
+private:
+    friend class ParallelSearch;
+
+    // run() without clearing the stop flag first
+    SearchResult iterate(const ChessBoard& board, const SearchLimits& limits);
+    bool skipsDepth(int depth) const;
+
+    int negamax(int depth, int alpha, int beta, int ply);
+    int quiescence(int alpha, int beta, int ply);
+
+    void scoreMoves(const MoveList& moves, int* scores, Move hashMove, int ply) const;
+    void updateQuietStats(Move move, int depth, int ply);
+    bool isCapture(Move move) const;
+
+    void checkLimits();
+    std::string principalVariation(int maxLength);
+
+    using Clock = std::chrono::steady_clock;
+
+    TranspositionTable& table_;
+    int threadIndex_;
+    ChessBoard board_;
+
+    SearchLimits limits_;
+    Clock::time_point start_;
+    std::uint64_t nodes_ = 0;
+    std::uint64_t tableHits_ = 0;     // this thread's own counts: no
+    std::uint64_t tableMisses_ = 0;   // cache line is shared with the
+    std::uint64_t tableEvictions_ = 0; // other search threads
+    std::atomic<bool> stopped_{ false };
+    Move rootBest_;
+
+    Move killers_[ChessBoard::kMaxPly][2];
+    int history_[2][64][64];
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "transposition_table.hpp"
+
+#include <climits>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/*
+ * Packed slot data (64 bits):
+ *   bits  0-15  move
+ *   bits 16-31  score (int16)
+ *   bits 32-39  depth (int8)
+ *   bits 40-41  bound
+ *   bit  42     status known
+ *   bits 43-44  status
+ *   bits 48-55  generation
+ *   bit  63     always set, so a used slot is never all zero
+ */
+namespace {
+
+constexpr std::uint64_t kUsedBit = std::uint64_t(1) << 63;
+constexpr std::uint64_t kStatusKnownBit = std::uint64_t(1) << 42;
+constexpr std::uint64_t kStatusMask = std::uint64_t(3) << 43;
+constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+std::uint64_t pack(Move move, int score, int depth, Bound bound,
+                   std::uint8_t generation) {
+    return std::uint64_t(move.raw())
+         | std::uint64_t(std::uint16_t(std::int16_t(score))) << 16
+         | std::uint64_t(std::uint8_t(std::int8_t(depth))) << 32
+         | std::uint64_t(bound) << 40
+         | std::uint64_t(generation) << 48
+         | kUsedBit;
+}
+
+std::uint64_t withStatus(std::uint64_t data, GameStatus status) {
+    return (data & ~kStatusMask) | kStatusKnownBit |
+           std::uint64_t(status) << 43;
+}
+
+Move moveOf(std::uint64_t data) { return Move::fromRaw(std::uint16_t(data)); }
+int depthOf(std::uint64_t data) { return std::int8_t(data >> 32); }
+Bound boundOf(std::uint64_t data) { return Bound((data >> 40) & 3); }
+std::uint8_t generationOf(std::uint64_t data) { return std::uint8_t(data >> 48); }
+
+void unpack(std::uint64_t data, TTEntry& entry) {
+    entry.move = moveOf(data);
+    entry.score = std::int16_t(data >> 16);
+    entry.depth = depthOf(data);
+    entry.bound = boundOf(data);
+    entry.statusKnown = (data & kStatusKnownBit) != 0;
+    entry.status = GameStatus((data >> 43) & 3);
+}
+
+} // namespace
+
+/* ---------------- Allocation ---------------- */
+
+TranspositionTable::TranspositionTable(std::size_t megabytes, bool hugePages) {
+    std::size_t bytes = megabytes * 1024 * 1024;
+
+    bucketCount_ = 1;
+    while (bucketCount_ * 2 * sizeof(Bucket) <= bytes)
+        bucketCount_ *= 2;
+
+    std::size_t size = bucketCount_ * sizeof(Bucket);
+    void* memory = nullptr;
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    // Explicit huge pages need a reserved pool; fall back quietly without one
+    if (hugePages && size % kHugePageSize == 0) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            memory = p;
+            mapped_ = true;
+            hugePages_ = true;
+        }
+    }
+#endif
+
+    if (!memory) {
+        std::size_t alignment = hugePages ? kHugePageSize : alignof(Bucket);
+        if (posix_memalign(&memory, alignment, size) != 0)
+            throw std::bad_alloc();
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // Transparent huge pages, where the kernel allows them
+        if (hugePages)
+            hugePages_ = madvise(memory, size, MADV_HUGEPAGE) == 0;
+#endif
+    }
+
+    buckets_ = static_cast<Bucket*>(memory);
+    for (std::size_t i = 0; i < bucketCount_; ++i)
+        new (&buckets_[i]) Bucket;
+
+    clear();
+}
+
+TranspositionTable::~TranspositionTable() {
+#if defined(__linux__)
+    if (mapped_) {
+        munmap(buckets_, bucketCount_ * sizeof(Bucket));
+        return;
+    }
+#endif
+    std::free(buckets_);
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < bucketCount_; ++i) {
+        for (Slot& slot : buckets_[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation_.store(0, std::memory_order_relaxed);
+}
+
+void TranspositionTable::newSearch() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/* ---------------- Probe / Store ---------------- */
+
+bool TranspositionTable::probe(std::uint64_t key, TTEntry& entry) const {
+    for (const Slot& slot : bucketFor(key).slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if (data && (check ^ data) == key) {
+            unpack(data, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::write(Slot& slot, std::uint64_t key, std::uint64_t data) {
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::store(std::uint64_t key, Move move, int score,
+                               int depth, Bound bound) {
+    std::uint8_t generation = generation_.load(std::memory_order_relaxed);
+    Bucket& bucket = bucketFor(key);
+
+    for (Slot& slot : bucket.slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        // Same position: refresh it unless the old entry is clearly better
+        if (data && (check ^ data) == key) {
+            if (bound != Bound::Exact &&
+                generationOf(data) == generation &&
+                depth < depthOf(data) - 2)
+                return false;
+
+            if (move.isNull())
+                move = moveOf(data);
+
+            std::uint64_t packed = pack(move, score, depth, bound, generation);
+            if (data & kStatusKnownBit)
+                packed = withStatus(packed, GameStatus((data >> 43) & 3));
+            write(slot, key, packed);
+            return false;
+        }
+    }
+
+    return insert(bucket, key, pack(move, score, depth, bound, generation));
+}
+
+void TranspositionTable::storeStatus(std::uint64_t key, GameStatus status) {
+    std::uint8_t generation = generation_.load(std::memory_order_relaxed);
+    Bucket& bucket = bucketFor(key);
+
+    for (Slot& slot : bucket.slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data && (check ^ data) == key) {
+            write(slot, key, withStatus(data, status));
+            return;
+        }
+    }
+
+    // New position: a status-only entry with no search data
+    insert(bucket, key,
+           withStatus(pack(Move(), 0, 0, Bound::None, generation), status));
+}
+
+bool TranspositionTable::insert(Bucket& bucket, std::uint64_t key,
+                                std::uint64_t data) {
+    std::uint8_t generation = generationOf(data);
+
+    // Replace the emptiest / shallowest / oldest slot
+    Slot* victim = &bucket.slots[0];
+    int victimValue = INT_MAX;
+
+    for (Slot& slot : bucket.slots) {
+        std::uint64_t old = slot.data.load(std::memory_order_relaxed);
+        int value = INT_MIN;
+        if (old) {
+            int age = std::uint8_t(generation - generationOf(old));
+            value = depthOf(old) - 8 * age;
+        }
+        if (value < victimValue) {
+            victimValue = value;
+            victim = &slot;
+        }
+    }
+
+    write(*victim, key, data);
+    return victimValue != INT_MIN;
+}
+
+/* ---------------- Stats ---------------- */
+
+int TranspositionTable::hashfull() const {
+    std::uint8_t generation = generation_.load(std::memory_order_relaxed);
+    std::size_t sampled = bucketCount_ < 250 ? bucketCount_ : 250;
+
+    int used = 0;
+    for (std::size_t i = 0; i < sampled; ++i) {
+        for (const Slot& slot : buckets_[i].slots) {
+            std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (data && generationOf(data) == generation)
+                ++used;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sampled * kSlotsPerBucket));
+}
+
+/* ---------------- Status cache ---------------- */
+
+GameStatus cachedStatus(const ChessBoard& board, TranspositionTable& table) {
+    TTEntry entry;
+    if (table.probe(board.hash(), entry) && entry.statusKnown)
+        return entry.status;
+
+    GameStatus status = board.status();
+    table.storeStatus(board.hash(), status);
+    return status;
+}
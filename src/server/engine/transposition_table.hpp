@@ -0,0 +1,101 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "chess/chess_board.hpp"
+
+/* ---------------- Entry ---------------- */
+
+// How a stored score relates to the true value
+enum class Bound : std::uint8_t { None, Exact, Lower, Upper };
+
+struct TTEntry {
+    Move move;
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::None;
+
+    // Terminal status of the position, if anyone has worked it out
+    bool statusKnown = false;
+    GameStatus status = GameStatus::Ongoing;
+};
+
+/* ---------------- TranspositionTable ---------------- */
+
+/*
+ * Fixed-size hash table of positions shared by every thread without locks.
+ *
+ * The table is a power-of-two array of 64-byte buckets (one cache line),
+ * each holding four slots. A slot is two 64-bit words: the packed data and
+ * key ^ data. Readers and writers touch the words with relaxed atomics and
+ * never lock; a reader only accepts a slot when its two words XOR back to
+ * the probed key, so a slot torn by a concurrent writer reads as a miss
+ * instead of returning another position's data.
+ *
+ * The table keeps no counters: one shared counter would be written by
+ * every thread on every node. Each Search counts its own hits, misses and
+ * evictions instead (see SearchResult).
+ */
+class TranspositionTable {
+public:
+    // Allocates once; sizes are rounded down to a power of two buckets
+    explicit TranspositionTable(std::size_t megabytes, bool hugePages = false);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(std::uint64_t key, TTEntry& entry) const;
+    // Returns true if the entry pushed another position out of its bucket
+    bool store(std::uint64_t key, Move move, int score, int depth, Bound bound);
+
+    // Records a terminal-status answer, keeping any search data for the key
+    void storeStatus(std::uint64_t key, GameStatus status);
+
+    // Ages existing entries so a new search prefers to replace them
+    void newSearch();
+    void clear();
+
+    std::size_t entryCount() const { return bucketCount_ * kSlotsPerBucket; }
+    std::size_t sizeBytes() const { return bucketCount_ * sizeof(Bucket); }
+    bool usesHugePages() const { return hugePages_; }
+
+    // Permille of slots filled in the current search (sampled)
+    int hashfull() const;
+
+private:
+    static constexpr int kSlotsPerBucket = 4;
+
+    struct Slot {
+        std::atomic<std::uint64_t> check; // key ^ data
+        std::atomic<std::uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[kSlotsPerBucket];
+    };
+
+    Bucket& bucketFor(std::uint64_t key) const {
+        return buckets_[key & (bucketCount_ - 1)];
+    }
+
+    void write(Slot& slot, std::uint64_t key, std::uint64_t data);
+    bool insert(Bucket& bucket, std::uint64_t key, std::uint64_t data);
+
+    Bucket* buckets_ = nullptr;
+    std::size_t bucketCount_ = 0;
+    bool hugePages_ = false;
+    bool mapped_ = false;
+
+    std::atomic<std::uint8_t> generation_{ 0 };
+};
+
+/* ---------------- Status cache ---------------- */
+
+// board.status(), answered from the table when the position was seen before
+GameStatus cachedStatus(const ChessBoard& board, TranspositionTable& table);
+
+#endif
@@ -0,0 +1,102 @@
+#include "chess_clock.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+/* ---------------- TimeControl ---------------- */
+
+bool parseTimeControl(std::string_view text, TimeControl& control) {
+    std::string copy(text);
+    char* rest = nullptr;
+
+    double minutes = std::strtod(copy.c_str(), &rest);
+    if (rest == copy.c_str() || minutes < 0)
+        return false;
+
+    double increment = 0;
+    if (*rest == '+') {
+        const char* start = rest + 1;
+        increment = std::strtod(start, &rest);
+        if (rest == start || increment < 0)
+            return false;
+    }
+    if (*rest != '\0')
+        return false;
+
+    control.base = std::chrono::milliseconds(static_cast<long long>(minutes * 60000));
+    control.increment = std::chrono::milliseconds(static_cast<long long>(increment * 1000));
+    return true;
+}
+
+/* ---------------- ChessClock ---------------- */
+
+ChessClock::ChessClock(const TimeControl& control) : control_(control) {
+    left_[0] = left_[1] = control.base;
+}
+
+void ChessClock::start(Clock::time_point now) {
+    toMove_ = Color::White;
+    turnStart_ = now;
+    running_ = true;
+}
+
+void ChessClock::stop(Clock::time_point now) {
+    if (!running_)
+        return;
+    Clock::duration& left = left_[colorIndex(toMove_)];
+    left = std::max(Clock::duration::zero(), left - used(now));
+    running_ = false;
+}
+
+void ChessClock::restore(std::chrono::milliseconds white,
+                         std::chrono::milliseconds black, Color toMove) {
+    left_[colorIndex(Color::White)] = white;
+    left_[colorIndex(Color::Black)] = black;
+    toMove_ = toMove;
+    running_ = false;
+}
+
+void ChessClock::resume(Clock::time_point now) {
+    turnStart_ = now;
+    running_ = true;
+}
+
+ChessClock::Clock::duration ChessClock::used(Clock::time_point now) const {
+    // The delay is spent first and never comes off the clock
+    Clock::duration elapsed = now - turnStart_;
+    return std::max(Clock::duration::zero(), elapsed - control_.delay);
+}
+
+bool ChessClock::press(Color mover, Clock::time_point now) {
+    if (!running_ || mover != toMove_)
+        return true;
+
+    Clock::duration& left = left_[colorIndex(mover)];
+    Clock::duration spent = used(now);
+    if (spent >= left)
+        return false;
+
+    left += control_.increment - spent;
+    toMove_ = opposite(mover);
+    turnStart_ = now;
+    return true;
+}
+
+std::chrono::milliseconds ChessClock::remaining(Color color,
+                                                Clock::time_point now) const {
+    Clock::duration left = left_[colorIndex(color)];
+    if (running_ && color == toMove_)
+        left = std::max(Clock::duration::zero(), left - used(now));
+    return std::chrono::duration_cast<std::chrono::milliseconds>(left);
+}
+
+ChessClock::Clock::time_point ChessClock::flagTime() const {
+    if (!running_)
+        return Clock::time_point::max();
+    return turnStart_ + control_.delay + left_[colorIndex(toMove_)];
+}
+
+bool ChessClock::hasFlagged(Clock::time_point now) const {
+    return running_ && used(now) >= left_[colorIndex(toMove_)];
+}
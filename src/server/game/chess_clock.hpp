@@ -0,0 +1,76 @@
+#ifndef CHESS_CLOCK_HPP
+#define CHESS_CLOCK_HPP
+
+#include <array>
+#include <chrono>
+#include <string_view>
+
+#include "chess/chess_board.hpp"
+
+/* ---------------- TimeControl ---------------- */
+
+// "5+3": five minutes each, three seconds added after every move.
+// A delay is time at the start of each move that is not charged.
+struct TimeControl {
+    std::chrono::milliseconds base{ 0 };      // 0 = untimed
+    std::chrono::milliseconds increment{ 0 };
+    std::chrono::milliseconds delay{ 0 };
+
+    bool enabled() const { return base.count() > 0; }
+};
+
+// "5+3": minutes, then seconds added per move; false if it does not parse
+bool parseTimeControl(std::string_view text, TimeControl& control);
+
+/* ---------------- ChessClock ---------------- */
+
+/*
+ * The two clocks of one game. Only the side to move's clock runs: it
+ * starts with the game, and every move stops the mover's clock, adds the
+ * increment and starts the opponent's. Time is passed in, never read, so
+ * the clock is exact to test and the caller decides what "now" is.
+ */
+class ChessClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ChessClock() = default;
+    explicit ChessClock(const TimeControl& control);
+
+    const TimeControl& control() const { return control_; }
+    bool running() const { return running_; }
+
+    // White's clock starts
+    void start(Clock::time_point now);
+    void stop(Clock::time_point now);
+
+    // A stopped clock set to times saved earlier; resume() starts the
+    // side to move's clock again from there
+    void restore(std::chrono::milliseconds white, std::chrono::milliseconds black,
+                 Color toMove);
+    void resume(Clock::time_point now);
+
+    // `mover` finished their move at `now`. False, and nothing changes,
+    // if their time had already run out.
+    bool press(Color mover, Clock::time_point now);
+
+    std::chrono::milliseconds remaining(Color color, Clock::time_point now) const;
+
+    // When the side to move runs out of time, if nobody moves first
+    Clock::time_point flagTime() const;
+    bool hasFlagged(Clock::time_point now) const;
+
+    Color toMove() const { return toMove_; }
+
+private:
+    // Time charged to the side to move so far this turn
+    Clock::duration used(Clock::time_point now) const;
+
+    TimeControl control_;
+    std::array<Clock::duration, 2> left_{};
+    Color toMove_ = Color::White;
+    Clock::time_point turnStart_;
+    bool running_ = false;
+};
+
+#endif
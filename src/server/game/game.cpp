@@ -0,0 +1,129 @@
+#include "game.hpp"
+
+#include <utility>
+
+Game::Game(Id id, TranspositionTable& table, Strand strand,
+           const TimeControl& timeControl)
+    : id_(id), table_(table), strand_(std::move(strand)), clock_(timeControl) {
+    board_.initialize();
+    snapshots_.publish(board_.snapshot());
+}
+
+/* ---------------- Seats ---------------- */
+
+Color Game::seat(std::shared_ptr<Player> player, TimePoint now) {
+    Color color = players_[colorIndex(Color::White)] ? Color::Black
+                                                     : Color::White;
+    players_[colorIndex(color)] = std::move(player);
+    if (isFull()) {
+        started_ = true;
+        if (clock_.control().enabled())
+            clock_.start(now);
+    }
+    return color;
+}
+
+void Game::leave(Color color, TimePoint now) {
+    players_[colorIndex(color)].reset();
+
+    // Nobody is left to finish a game that already started
+    if (started_) {
+        over_ = true;
+        clock_.stop(now);
+    }
+}
+
+/* ---------------- Recovery ---------------- */
+
+bool Game::replay(Move move) {
+    Move legal = board_.findMove(squareX(move.from()), squareY(move.from()),
+                                 squareX(move.to()), squareY(move.to()),
+                                 move.isPromotion() ? move.promotion() : PieceType::Queen);
+    if (legal.isNull() || legal != move)
+        return false;
+
+    board_.playMove(legal);
+    lastMove_ = legal;
+    started_ = true;
+    return true;
+}
+
+void Game::reopen(std::chrono::milliseconds whiteLeft,
+                  std::chrono::milliseconds blackLeft) {
+    started_ = true;
+    clock_.restore(whiteLeft, blackLeft, board_.sideToMove());
+
+    snapshots_.publish(board_.snapshot());
+    status_ = cachedStatus(board_, table_);
+    over_ = status_ != GameStatus::Ongoing;
+}
+
+void Game::reseat(std::shared_ptr<Player> player, Color color, TimePoint now) {
+    players_[colorIndex(color)] = std::move(player);
+    if (isFull() && clock_.control().enabled())
+        clock_.resume(now);
+}
+
+/* ---------------- Spectators ---------------- */
+
+void Game::watch(std::shared_ptr<Player> spectator) {
+    spectators_.push_back(std::move(spectator));
+}
+
+void Game::unwatch(const Player* spectator) {
+    // Order does not matter; a big audience should not pay for a shift
+    for (std::size_t i = 0; i < spectators_.size(); ++i) {
+        if (spectators_[i].get() == spectator) {
+            std::swap(spectators_[i], spectators_.back());
+            spectators_.pop_back();
+            return;
+        }
+    }
+}
+
+/* ---------------- Moves ---------------- */
+
+MoveOutcome Game::play(Color color, int fx, int fy, int tx, int ty,
+                       PieceType promotion, TimePoint now) {
+    if (over_)
+        return MoveOutcome::GameOver;
+    if (!isFull())
+        return MoveOutcome::WaitingForOpponent;
+    if (color != board_.sideToMove())
+        return MoveOutcome::NotYourTurn;
+    if (checkFlag(now))
+        return MoveOutcome::OutOfTime;
+
+    const Piece* piece = board_.getPiece(fx, fy);
+    if (piece && piece->getColor() != color)
+        return MoveOutcome::NotYourPiece;
+
+    Move move = board_.findMove(fx, fy, tx, ty, promotion);
+    if (move.isNull())
+        return MoveOutcome::Illegal;
+
+    board_.playMove(move);
+    lastMove_ = move;
+    clock_.press(color, now);
+
+    snapshots_.publish(board_.snapshot());
+
+    // Many games pass through the same positions; ask the shared table first
+    status_ = cachedStatus(board_, table_);
+    if (status_ != GameStatus::Ongoing) {
+        over_ = true;
+        clock_.stop(now);
+    }
+
+    return MoveOutcome::Played;
+}
+
+bool Game::checkFlag(TimePoint now) {
+    if (over_ || !clock_.hasFlagged(now))
+        return false;
+
+    over_ = true;
+    timedOut_ = true;
+    clock_.stop(now);
+    return true;
+}
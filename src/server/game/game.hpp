@@ -0,0 +1,156 @@
+#ifndef GAME_HPP
+#define GAME_HPP
+
+#include <array>
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chess/board_snapshot.hpp"
+#include "chess/chess_board.hpp"
+#include "engine/transposition_table.hpp"
+#include "chess_clock.hpp"
+
+struct Player; // a connection, defined by the networking layer
+
+/* ---------------- MoveOutcome ---------------- */
+
+enum class MoveOutcome {
+    Played,
+    NotYourTurn,
+    NotYourPiece,
+    Illegal,
+    WaitingForOpponent,
+    GameOver,
+    OutOfTime    // the mover's flag fell before the move; the game is over
+};
+
+/* ---------------- Game ---------------- */
+
+/*
+ * One game: its board, its two seats, the connections watching it and
+ * whether it is still going.
+ * It knows nothing about sockets; the networking layer seats players,
+ * forwards their moves and reports the outcome back to them.
+ *
+ * A Game is not locked. Everything that touches it runs on its strand,
+ * so games proceed in parallel on the server's thread pool while each
+ * one sees its events one at a time. Every played move publishes a
+ * snapshot, so other threads can read the position without the strand.
+ *
+ * With a time control the clock starts when the second player sits down.
+ * Nothing here watches it: whoever looks next (a move, or the server's
+ * timing wheel) calls checkFlag() and finds the flag down.
+ *
+ * After a restart a game is rebuilt from the move log (move_log.hpp):
+ * replay() plays its moves again, reopen() puts the clocks back, and it
+ * waits with empty seats until each player comes back with their resume
+ * key and reseat() gives them their seat.
+ */
+class Game {
+public:
+    using Id = std::uint64_t;
+    using Strand = boost::asio::strand<boost::asio::io_context::executor_type>;
+    using TimePoint = ChessClock::Clock::time_point;
+
+    Game(Id id, TranspositionTable& table, Strand strand,
+         const TimeControl& timeControl = {});
+
+    Id id() const { return id_; }
+    const Strand& strand() const { return strand_; }
+
+    // Seats: White first, then Black
+    bool isFull() const { return players_[0] && players_[1]; }
+    bool isEmpty() const { return !players_[0] && !players_[1]; }
+    Color seat(std::shared_ptr<Player> player,  // requires !isFull()
+               TimePoint now = ChessClock::Clock::now());
+    void leave(Color color, TimePoint now = ChessClock::Clock::now());
+
+    const std::shared_ptr<Player>& player(Color color) const {
+        return players_[colorIndex(color)];
+    }
+
+    // Kept by the players of a logged game, to claim their seats after a
+    // restart; 0 = none
+    void setResumeKeys(std::uint64_t white, std::uint64_t black) {
+        resumeKeys_ = { white, black };
+    }
+    std::uint64_t resumeKey(Color color) const {
+        return resumeKeys_[colorIndex(color)];
+    }
+
+    // Recovery: a logged move, played with nobody seated; false if it is
+    // not legal here
+    bool replay(Move move);
+
+    // Recovery done: clocks as logged, stopped until both players are back
+    void reopen(std::chrono::milliseconds whiteLeft,
+                std::chrono::milliseconds blackLeft);
+
+    // A recovered game still missing a player
+    bool awaitingReturn() const { return started_ && !over_ && !isFull(); }
+
+    // A player back in their seat; the clock runs again once both are
+    void reseat(std::shared_ptr<Player> player, Color color,  // requires awaitingReturn()
+                TimePoint now = ChessClock::Clock::now());
+
+    // Spectators see every move but hold no seat
+    void watch(std::shared_ptr<Player> spectator);
+    void unwatch(const Player* spectator);
+
+    const std::vector<std::shared_ptr<Player>>& spectators() const {
+        return spectators_;
+    }
+
+    // A move by the player of `color`; only their own pieces, on their turn
+    MoveOutcome play(Color color, int fx, int fy, int tx, int ty,
+                     PieceType promotion = PieceType::Queen,
+                     TimePoint now = ChessClock::Clock::now());
+
+    // Ends the game if the side to move is out of time; true only the
+    // one time that happens
+    bool checkFlag(TimePoint now = ChessClock::Clock::now());
+
+    // Lost on time: the loser is the side to move
+    bool timedOut() const { return timedOut_; }
+
+    const ChessClock& clock() const { return clock_; }
+
+    // Only before the game starts
+    void setTimeControl(const TimeControl& control) { clock_ = ChessClock(control); }
+
+    // The move last played (null before the first one)
+    Move lastMove() const { return lastMove_; }
+
+    // Status for the side to move, as of the last move
+    GameStatus status() const { return status_; }
+
+    // Finished by mate, stalemate, time or a player leaving mid-game
+    bool isOver() const { return over_; }
+
+    const ChessBoard& board() const { return board_; }
+    const SnapshotPublisher& snapshots() const { return snapshots_; }
+
+private:
+    Id id_;
+    TranspositionTable& table_;
+    Strand strand_;
+
+    ChessBoard board_;
+    std::array<std::shared_ptr<Player>, 2> players_;
+    std::vector<std::shared_ptr<Player>> spectators_;
+    bool started_ = false;
+    std::array<std::uint64_t, 2> resumeKeys_{};
+
+    Move lastMove_;
+    GameStatus status_ = GameStatus::Ongoing;
+    bool over_ = false;
+
+    ChessClock clock_;
+    bool timedOut_ = false;
+
+    SnapshotPublisher snapshots_;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "game_registry.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "move_log.hpp"
+
+std::shared_ptr<Game> GameRegistry::openGame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto game = std::make_shared<Game>(nextId_++, table_,
+                                       boost::asio::make_strand(io_),
+                                       timeControl_);
+    games_.emplace(game->id(), game);
+    return game;
+}
+
+std::vector<std::shared_ptr<Game>>
+GameRegistry::restore(const std::vector<LoggedGame>& logged, int threads) {
+    std::vector<std::shared_ptr<Game>> games(logged.size());
+
+    // Games replay independently; each thread takes every n-th one
+    auto replay = [&](std::size_t first, std::size_t step) {
+        for (std::size_t i = first; i < logged.size(); i += step) {
+            const LoggedGame& entry = logged[i];
+            auto game = std::make_shared<Game>(entry.id, table_,
+                                               boost::asio::make_strand(io_),
+                                               entry.timeControl);
+
+            bool replayed = std::all_of(entry.moves.begin(), entry.moves.end(),
+                                        [&](Move move) { return game->replay(move); });
+            if (!replayed)
+                continue;
+
+            game->reopen(entry.clockLeft[0], entry.clockLeft[1]);
+            game->setResumeKeys(entry.resumeKeys[0], entry.resumeKeys[1]);
+            games[i] = std::move(game);
+        }
+    };
+
+    std::size_t workers = std::max(1, threads);
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < workers; ++t)
+        pool.emplace_back(replay, t, workers);
+    replay(0, workers);
+    for (std::thread& thread : pool)
+        thread.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& game : games)
+        if (game)
+            games_.emplace(game->id(), game);
+    for (const LoggedGame& entry : logged)
+        nextId_ = std::max(nextId_, entry.id + 1);
+    return games;
+}
+
+std::shared_ptr<Game> GameRegistry::find(Game::Id id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = games_.find(id);
+    return it == games_.end() ? nullptr : it->second;
+}
+
+void GameRegistry::remove(Game::Id id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    games_.erase(id);
+}
+
+std::size_t GameRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return games_.size();
+}
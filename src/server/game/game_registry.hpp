@@ -0,0 +1,56 @@
+#ifndef GAME_REGISTRY_HPP
+#define GAME_REGISTRY_HPP
+
+#include <boost/asio.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "game.hpp"
+
+struct LoggedGame;
+
+/* ---------------- GameRegistry ---------------- */
+
+/*
+ * Every live game on the server, by ID. Each new connection opens a game
+ * of its own, with its own strand, and waits there; the matchmaker
+ * (matchmaker.hpp) later brings an opponent over.
+ *
+ * The registry is shared by all io threads and takes a mutex, but only
+ * on connect and disconnect; moves never touch it.
+ */
+class GameRegistry {
+public:
+    GameRegistry(TranspositionTable& table, boost::asio::io_context& io,
+                 const TimeControl& timeControl = {})
+        : table_(table), io_(io), timeControl_(timeControl) {}
+
+    // A new, empty game with the server's time control
+    std::shared_ptr<Game> openGame();
+
+    // Rebuilds logged games (move_log.hpp) by replaying their moves, on
+    // `threads` threads. Same order as `logged`; null where a move did not
+    // replay. New games get IDs after all of them.
+    std::vector<std::shared_ptr<Game>> restore(const std::vector<LoggedGame>& logged,
+                                               int threads = 1);
+
+    std::shared_ptr<Game> find(Game::Id id) const;
+    bool contains(Game::Id id) const { return find(id) != nullptr; }
+    void remove(Game::Id id);
+
+    std::size_t size() const;
+
+private:
+    TranspositionTable& table_;
+    boost::asio::io_context& io_;
+    TimeControl timeControl_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Game::Id, std::shared_ptr<Game>> games_;
+    Game::Id nextId_ = 1;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "matchmaker.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Rating band: starts narrow and widens with every second of waiting
+constexpr int kBaseBand = 50;
+constexpr int kBandPerSecond = 100;
+constexpr int kMaxBand = 800;
+
+// Percentiles are taken over this many of the latest waits
+constexpr std::size_t kRecentWaits = 4096;
+
+std::chrono::milliseconds percentile(std::vector<std::int64_t>& waits, int p) {
+    std::size_t at = (waits.size() - 1) * p / 100;
+    std::nth_element(waits.begin(), waits.begin() + at, waits.end());
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::microseconds(waits[at]));
+}
+
+} // namespace
+
+/* ---------------- Pool ---------------- */
+
+Matchmaker::PoolKey Matchmaker::poolKey(const TimeControl& control) {
+    return { control.base.count(), control.increment.count(), control.delay.count() };
+}
+
+int Matchmaker::ratingBand(Clock::duration waited) {
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(waited).count();
+    long long band = kBaseBand + kBandPerSecond * millis / 1000;
+    return static_cast<int>(std::min<long long>(band, kMaxBand));
+}
+
+Matchmaker::Ticket Matchmaker::enqueue(Seeker seeker) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Ticket ticket = nextTicket_++;
+    seeker.ticket = ticket;
+    pools_[poolKey(seeker.timeControl)].push_back({ seeker.rating, ticket });
+    waiting_.emplace(ticket, std::move(seeker));
+    return ticket;
+}
+
+bool Matchmaker::cancel(Ticket ticket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiting_.erase(ticket) != 0;
+}
+
+std::size_t Matchmaker::waiting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiting_.size();
+}
+
+std::size_t Matchmaker::pools() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pools_.size();
+}
+
+/* ---------------- Pairing ---------------- */
+
+void Matchmaker::tick(Clock::time_point now, std::vector<Match>& matches) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = pools_.begin(); it != pools_.end(); ) {
+        std::vector<Entry>& pool = it->second;
+        pool.erase(std::remove_if(pool.begin(), pool.end(),
+                                  [this](const Entry& entry) {
+                                      return waiting_.count(entry.ticket) == 0;
+                                  }),
+                   pool.end());
+
+        // Mostly sorted already from the last tick
+        std::sort(pool.begin(), pool.end(), [](const Entry& a, const Entry& b) {
+            return a.rating < b.rating;
+        });
+
+        // Neighbours in rating order, each player in at most one pair
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < pool.size(); ) {
+            if (i + 1 < pool.size()) {
+                auto first = waiting_.find(pool[i].ticket);
+                auto second = waiting_.find(pool[i + 1].ticket);
+
+                int band = std::max(ratingBand(now - first->second.since),
+                                    ratingBand(now - second->second.since));
+
+                if (pool[i + 1].rating - pool[i].rating <= band) {
+                    if (second->second.since < first->second.since)
+                        std::swap(first, second);
+
+                    recordWait(now - first->second.since);
+                    recordWait(now - second->second.since);
+                    matches.push_back({ std::move(first->second),
+                                        std::move(second->second) });
+                    waiting_.erase(first);
+                    waiting_.erase(second);
+                    ++matches_;
+                    i += 2;
+                    continue;
+                }
+            }
+            pool[kept++] = pool[i++];
+        }
+        pool.resize(kept);
+
+        // A time control nobody waits for costs nothing until someone seeks it
+        if (pool.empty())
+            it = pools_.erase(it);
+        else
+            ++it;
+    }
+}
+
+/* ---------------- Stats ---------------- */
+
+void Matchmaker::recordWait(Clock::duration waited) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+    if (recentWaits_.size() < kRecentWaits) {
+        recentWaits_.push_back(micros);
+        return;
+    }
+    recentWaits_[nextWait_] = micros;
+    nextWait_ = (nextWait_ + 1) % kRecentWaits;
+}
+
+Matchmaker::Stats Matchmaker::stats() const {
+    std::vector<std::int64_t> waits;
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.waiting = waiting_.size();
+        stats.matches = matches_;
+        waits = recentWaits_;
+    }
+
+    if (waits.empty())
+        return stats;
+
+    stats.p50 = percentile(waits, 50);
+    stats.p90 = percentile(waits, 90);
+    stats.p99 = percentile(waits, 99);
+    stats.max = percentile(waits, 100);
+    return stats;
+}
@@ -0,0 +1,111 @@
+#ifndef MATCHMAKER_HPP
+#define MATCHMAKER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "chess_clock.hpp"
+
+struct Player; // a connection, defined by the networking layer
+class Game;
+
+/* ---------------- Seeker ---------------- */
+
+// A player looking for an opponent, and the game they wait in
+struct Seeker {
+    using Ticket = std::uint64_t;
+
+    std::shared_ptr<Player> player;
+    std::shared_ptr<Game> game;
+    int rating = 1500;
+    TimeControl timeControl;
+    std::chrono::steady_clock::time_point since;
+
+    Ticket ticket = 0; // set by Matchmaker::enqueue()
+};
+
+// Two seekers paired; the game is played in host.game
+struct Match {
+    Seeker host;   // waited longer
+    Seeker guest;
+};
+
+/* ---------------- Matchmaker ---------------- */
+
+/*
+ * The pool of players waiting for a game, one pool per time control.
+ *
+ * Nothing is paired on arrival. tick() pairs each pool in one batch: it
+ * sorts the pool by rating and matches neighbours whose gap is within
+ * the band of either one. The band widens the longer a player waits, so
+ * nobody waits forever for a perfect opponent. Time is passed in, so
+ * the synthetic load in matchmaking_bench can run faster than real time.
+ *
+ * Thread-safe; one mutex, held for an enqueue, a cancel or a tick.
+ */
+class Matchmaker {
+public:
+    using Ticket = Seeker::Ticket;
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        std::size_t waiting = 0;
+        std::uint64_t matches = 0;
+
+        // Seek-to-match wait over the most recent pairings
+        std::chrono::milliseconds p50{ 0 };
+        std::chrono::milliseconds p90{ 0 };
+        std::chrono::milliseconds p99{ 0 };
+        std::chrono::milliseconds max{ 0 };
+    };
+
+    Ticket enqueue(Seeker seeker);
+
+    // False if the ticket was already matched or cancelled
+    bool cancel(Ticket ticket);
+
+    // Pairs whoever can be paired at `now`; appends to `matches`
+    void tick(Clock::time_point now, std::vector<Match>& matches);
+
+    Stats stats() const;
+    std::size_t waiting() const;
+
+    // Time controls with someone waiting, as of the last tick
+    std::size_t pools() const;
+
+    // Largest rating gap a player accepts after waiting this long
+    static int ratingBand(Clock::duration waited);
+
+private:
+    using PoolKey = std::tuple<long long, long long, long long>;
+
+    struct Entry {
+        int rating;
+        Ticket ticket;
+    };
+
+    static PoolKey poolKey(const TimeControl& control);
+    void recordWait(Clock::duration waited);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Ticket, Seeker> waiting_;
+
+    // Tickets by time control; cancelled ones are dropped, and pools left
+    // empty erased, at the next tick
+    std::map<PoolKey, std::vector<Entry>> pools_;
+    Ticket nextTicket_ = 1;
+
+    // Ring of the latest waits, in microseconds
+    std::vector<std::int64_t> recentWaits_;
+    std::size_t nextWait_ = 0;
+    std::uint64_t matches_ = 0;
+};
+
+#endif
@@ -0,0 +1,431 @@
+#include "move_log.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Record types
+constexpr char kStart = 'S';
+constexpr char kMove  = 'M';
+constexpr char kEnd   = 'E';
+
+// type(1) game(8), then the fields, then a checksum(4); little-endian
+constexpr std::size_t kStartSize = 1 + 8 + 12 + 16 + 4;
+constexpr std::size_t kMoveSize  = 1 + 8 + 2 + 4 + 4;
+constexpr std::size_t kEndSize   = 1 + 8 + 4;
+
+constexpr std::size_t recordSize(char type) {
+    return type == kStart ? kStartSize
+         : type == kMove  ? kMoveSize
+         : type == kEnd   ? kEndSize
+                          : 0;
+}
+
+// FNV-1a
+std::uint32_t checksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<std::uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+char* put(char* out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        *out++ = static_cast<char>(static_cast<std::uint64_t>(value) >> (8 * i));
+    return out;
+}
+
+template <typename T>
+T get(const char* in) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value |= std::uint64_t(static_cast<std::uint8_t>(in[i])) << (8 * i);
+    return static_cast<T>(value);
+}
+
+void seal(char* record, std::size_t size) {
+    put<std::uint32_t>(record + size - 4, checksum(record, size - 4));
+}
+
+std::uint32_t millis(std::chrono::milliseconds value) {
+    return static_cast<std::uint32_t>(std::max<long long>(0, value.count()));
+}
+
+std::size_t encodeStart(char* out, Game::Id id, const TimeControl& control,
+                        std::uint64_t whiteKey, std::uint64_t blackKey) {
+    char* at = put<char>(out, kStart);
+    at = put<std::uint64_t>(at, id);
+    at = put<std::uint32_t>(at, millis(control.base));
+    at = put<std::uint32_t>(at, millis(control.increment));
+    at = put<std::uint32_t>(at, millis(control.delay));
+    at = put<std::uint64_t>(at, whiteKey);
+    put<std::uint64_t>(at, blackKey);
+    seal(out, kStartSize);
+    return kStartSize;
+}
+
+std::size_t encodeMove(char* out, Game::Id id, Move move,
+                       std::chrono::milliseconds moverLeft) {
+    char* at = put<char>(out, kMove);
+    at = put<std::uint64_t>(at, id);
+    at = put<std::uint16_t>(at, move.raw());
+    put<std::uint32_t>(at, millis(moverLeft));
+    seal(out, kMoveSize);
+    return kMoveSize;
+}
+
+std::size_t encodeEnd(char* out, Game::Id id) {
+    char* at = put<char>(out, kEnd);
+    put<std::uint64_t>(at, id);
+    seal(out, kEndSize);
+    return kEndSize;
+}
+
+// A failed write or sync leaves a hole in the log; acknowledging moves
+// after that would promise what cannot be kept, so stop here
+[[noreturn]] void fail(const char* what) {
+    std::cerr << "Move log: " << what << " failed: " << std::strerror(errno)
+              << std::endl;
+    std::abort();
+}
+
+void writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            fail("write");
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void syncData(int fd) {
+#if defined(__APPLE__)
+    int result = ::fsync(fd);
+#else
+    int result = ::fdatasync(fd);
+#endif
+    if (result != 0)
+        fail("sync");
+}
+
+// Shard of a game. IDs come in patterns (every other one is a lobby that
+// never starts), so they are mixed first, or whole shards would sit idle.
+std::size_t shardIndex(Game::Id id, std::size_t shards) {
+    return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ull) >> 32) % shards;
+}
+
+fs::path shardPath(const fs::path& directory, int shard) {
+    return directory / ("moves-" + std::to_string(shard) + ".wal");
+}
+
+// Shard files in `directory`: moves-<n>.wal
+std::vector<fs::path> shardFiles(const fs::path& directory) {
+    std::vector<fs::path> files;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 10 && name.compare(0, 6, "moves-") == 0 &&
+            name.compare(name.size() - 4, 4, ".wal") == 0)
+            files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::string readFile(const fs::path& path) {
+    std::string data;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return data;
+
+    data.resize(static_cast<std::size_t>(fs::file_size(path)));
+    std::size_t done = 0;
+    while (done < data.size()) {
+        ssize_t got = ::read(fd, &data[done], data.size() - done);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            break;
+        done += static_cast<std::size_t>(got);
+    }
+    ::close(fd);
+    data.resize(done);
+    return data;
+}
+
+using GameMap = std::unordered_map<Game::Id, LoggedGame>;
+
+// Every game one file leaves unfinished, up to the first bad record
+GameMap readShard(const fs::path& path) {
+    GameMap games;
+    std::string data = readFile(path);
+
+    std::size_t at = 0;
+    while (at < data.size()) {
+        const char* record = data.data() + at;
+        std::size_t size = recordSize(record[0]);
+        if (size == 0 || data.size() - at < size ||
+            get<std::uint32_t>(record + size - 4) != checksum(record, size - 4))
+            break;
+        at += size;
+
+        Game::Id id = get<std::uint64_t>(record + 1);
+        if (record[0] == kStart) {
+            // A game logged twice (a rewrite cut short) starts over
+            LoggedGame& game = games[id];
+            game = LoggedGame();
+            game.id = id;
+            game.timeControl.base = std::chrono::milliseconds(get<std::uint32_t>(record + 9));
+            game.timeControl.increment = std::chrono::milliseconds(get<std::uint32_t>(record + 13));
+            game.timeControl.delay = std::chrono::milliseconds(get<std::uint32_t>(record + 17));
+            game.resumeKeys = { get<std::uint64_t>(record + 21),
+                                get<std::uint64_t>(record + 29) };
+            game.clockLeft = { game.timeControl.base, game.timeControl.base };
+        }
+        else if (record[0] == kMove) {
+            auto it = games.find(id);
+            if (it == games.end())
+                continue;
+            LoggedGame& game = it->second;
+
+            // White moves first, so the mover follows from the count
+            std::size_t mover = game.moves.size() % 2;
+            game.moves.push_back(Move::fromRaw(get<std::uint16_t>(record + 9)));
+            game.clockLeft[mover] = std::chrono::milliseconds(get<std::uint32_t>(record + 11));
+        }
+        else {
+            games.erase(id);
+        }
+    }
+    return games;
+}
+
+} // namespace
+
+/* ---------------- Shard ---------------- */
+
+struct MoveLog::Shard {
+    int fd = -1;
+    std::thread writer;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Records not yet written, and the moves waiting on them
+    std::string buffer;
+    std::vector<Durable> waiting;
+
+    Stats stats;
+
+    void run();
+};
+
+void MoveLog::Shard::run() {
+    // Swapped with the shared buffers, so a steady stream of batches
+    // reuses the same memory
+    std::string batch;
+    std::vector<Durable> done;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !buffer.empty(); });
+            if (buffer.empty())
+                return;
+            batch.swap(buffer);
+            done.swap(waiting);
+        }
+
+        writeAll(fd, batch.data(), batch.size());
+        syncData(fd);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.bytes += batch.size();
+            ++stats.syncs;
+        }
+
+        for (Durable& durable : done)
+            if (durable)
+                durable();
+        batch.clear();
+        done.clear();
+    }
+}
+
+/* ---------------- Recovery ---------------- */
+
+std::vector<LoggedGame> MoveLog::recover(const std::string& directory) {
+    std::vector<fs::path> files = shardFiles(directory);
+    std::vector<GameMap> shards(files.size());
+
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < files.size(); ++i)
+        readers.emplace_back([&, i] { shards[i] = readShard(files[i]); });
+    for (std::thread& reader : readers)
+        reader.join();
+
+    std::vector<LoggedGame> games;
+    for (GameMap& shard : shards)
+        for (auto& [id, game] : shard)
+            games.push_back(std::move(game));
+
+    // Files from a rewrite with a different shard count may overlap
+    std::sort(games.begin(), games.end(),
+              [](const LoggedGame& a, const LoggedGame& b) { return a.id < b.id; });
+    games.erase(std::unique(games.begin(), games.end(),
+                            [](const LoggedGame& a, const LoggedGame& b) {
+                                return a.id == b.id;
+                            }),
+                games.end());
+    return games;
+}
+
+/* ---------------- MoveLog ---------------- */
+
+MoveLog::MoveLog(const std::string& directory, int shards,
+                 const std::vector<LoggedGame>& live) {
+    fs::path dir(directory);
+    std::error_code error;
+    fs::create_directories(dir, error);
+
+    shards = std::max(1, shards);
+    std::vector<std::string> contents(shards);
+    char record[kStartSize];
+
+    for (const LoggedGame& game : live) {
+        std::string& out = contents[shardIndex(game.id, shards)];
+        out.append(record, encodeStart(record, game.id, game.timeControl,
+                                       game.resumeKeys[0], game.resumeKeys[1]));
+        for (std::size_t i = 0; i < game.moves.size(); ++i)
+            out.append(record, encodeMove(record, game.id, game.moves[i],
+                                          game.clockLeft[i % 2]));
+    }
+
+    // Each shard is written whole to a new file, then put in place of the
+    // old one, so a crash here leaves one or the other
+    for (int i = 0; i < shards; ++i) {
+        fs::path path = shardPath(dir, i);
+        fs::path temp = path;
+        temp += ".tmp";
+
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            throw std::runtime_error("cannot create " + temp.string() + ": " +
+                                     std::strerror(errno));
+        writeAll(fd, contents[i].data(), contents[i].size());
+        syncData(fd);
+        ::close(fd);
+
+        fs::rename(temp, path, error);
+        if (error)
+            throw std::runtime_error("cannot replace " + path.string() + ": " +
+                                     error.message());
+    }
+
+    // Shards of an earlier run with more of them
+    for (const fs::path& file : shardFiles(dir)) {
+        int index = std::atoi(file.filename().string().c_str() + 6);
+        if (index >= shards)
+            fs::remove(file, error);
+    }
+
+    if (int fd = ::open(dir.c_str(), O_RDONLY); fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+
+    for (int i = 0; i < shards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->fd = ::open(shardPath(dir, i).c_str(), O_WRONLY | O_APPEND);
+        if (shard->fd < 0)
+            throw std::runtime_error("cannot open " + shardPath(dir, i).string() +
+                                     ": " + std::strerror(errno));
+        shard->writer = std::thread([raw = shard.get()] { raw->run(); });
+        shards_.push_back(std::move(shard));
+    }
+}
+
+MoveLog::~MoveLog() {
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->stopping = true;
+        }
+        shard->wake.notify_one();
+    }
+    for (auto& shard : shards_) {
+        shard->writer.join();
+        ::close(shard->fd);
+    }
+}
+
+void MoveLog::append(Game::Id id, const char* record, std::size_t size,
+                     Durable durable) {
+    Shard& shard = *shards_[shardIndex(id, shards_.size())];
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        wasEmpty = shard.buffer.empty();
+        shard.buffer.append(record, size);
+        if (durable)
+            shard.waiting.push_back(std::move(durable));
+        ++shard.stats.records;
+    }
+
+    // The writer is asleep only when there was nothing to write
+    if (wasEmpty)
+        shard.wake.notify_one();
+}
+
+void MoveLog::logStart(Game::Id id, const TimeControl& control,
+                       std::uint64_t whiteKey, std::uint64_t blackKey) {
+    char record[kStartSize];
+    append(id, record, encodeStart(record, id, control, whiteKey, blackKey), {});
+}
+
+void MoveLog::logMove(Game::Id id, Move move, std::chrono::milliseconds moverLeft,
+                      Durable durable) {
+    char record[kMoveSize];
+    append(id, record, encodeMove(record, id, move, moverLeft), std::move(durable));
+}
+
+void MoveLog::logEnd(Game::Id id) {
+    char record[kEndSize];
+    append(id, record, encodeEnd(record, id), {});
+}
+
+MoveLog::Stats MoveLog::stats() const {
+    Stats total;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total.records += shard->stats.records;
+        total.bytes += shard->stats.bytes;
+        total.syncs += shard->stats.syncs;
+    }
+    return total;
+}
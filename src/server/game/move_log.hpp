@@ -0,0 +1,97 @@
+#ifndef MOVE_LOG_HPP
+#define MOVE_LOG_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "chess/move.hpp"
+#include "chess_clock.hpp"
+#include "game.hpp"
+
+/* ---------------- LoggedGame ---------------- */
+
+// An unfinished game as the log last saw it, enough to play it again
+struct LoggedGame {
+    Game::Id id = 0;
+    TimeControl timeControl;
+    std::array<std::uint64_t, 2> resumeKeys{};
+    std::vector<Move> moves;
+
+    // Time left after each side's last move (the base time before one)
+    std::array<std::chrono::milliseconds, 2> clockLeft{};
+};
+
+/* ---------------- MoveLog ---------------- */
+
+/*
+ * Write-ahead log of the games in progress, so a restart picks them up
+ * where they were.
+ *
+ * Games are spread over shards by ID, with one file and one writer thread
+ * per shard. Records are small and fixed-size: a game starting (41 bytes),
+ * a move (19) and a game ending (13). Logging copies the record into the
+ * shard's buffer and returns. The writer takes everything buffered,
+ * writes it, and calls fdatasync() once for the lot. While one sync is
+ * under way the next batch gathers, so a busy shard syncs hundreds of
+ * moves at a time and an idle one syncs each move as it comes. A move's
+ * callback runs on the writer thread once it is on disk.
+ *
+ * Every record ends in a checksum. Reading stops at the first record
+ * that is cut short or damaged: that is where a crash stopped the file.
+ * Opening the log rewrites the shards with only the games still going,
+ * so the files do not grow from one run to the next.
+ *
+ * Thread-safe; each shard takes its own mutex.
+ */
+class MoveLog {
+public:
+    using Durable = std::function<void()>;
+
+    struct Stats {
+        std::uint64_t records = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t syncs = 0;
+    };
+
+    // Every unfinished game logged in `directory`, one thread per file
+    static std::vector<LoggedGame> recover(const std::string& directory);
+
+    // `shards` logs in `directory` (created if need be), starting out with
+    // the games in `live`. Throws std::runtime_error if the files cannot
+    // be written.
+    MoveLog(const std::string& directory, int shards,
+            const std::vector<LoggedGame>& live = {});
+
+    // Writes and syncs what is still buffered
+    ~MoveLog();
+
+    MoveLog(const MoveLog&) = delete;
+    MoveLog& operator=(const MoveLog&) = delete;
+
+    void logStart(Game::Id id, const TimeControl& control,
+                  std::uint64_t whiteKey, std::uint64_t blackKey);
+
+    // `moverLeft`: the mover's clock after the move
+    void logMove(Game::Id id, Move move, std::chrono::milliseconds moverLeft,
+                 Durable durable);
+
+    void logEnd(Game::Id id);
+
+    int shards() const { return static_cast<int>(shards_.size()); }
+    Stats stats() const;
+
+private:
+    struct Shard;
+
+    void append(Game::Id id, const char* record, std::size_t size,
+                Durable durable);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/* ---------------- TimingWheel ---------------- */
+
+/*
+ * Hierarchical timing wheel: timers for any number of owners, driven by
+ * one periodic tick instead of one OS timer each.
+ *
+ * Time is counted in ticks. Level 0 has one slot per tick for the next 64
+ * ticks. Each level above has slots 64 times as wide. A timer goes into
+ * the lowest level that reaches its deadline. When level 0 wraps, the
+ * next slot up is emptied into the levels below, so a timer moves down at
+ * most once per level. Scheduling is O(1), and so is each tick, apart
+ * from the timers it fires or moves down.
+ *
+ * Timers cannot be cancelled. Owners check, when a timer fires, whether
+ * it still means anything. A stale timer costs one slot entry until its
+ * deadline.
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+template <typename T>
+class TimingWheel {
+public:
+    using Tick = std::uint64_t;
+
+    explicit TimingWheel(Tick now = 0) : now_(now) {}
+
+    Tick now() const { return now_; }
+    std::size_t size() const { return size_; }
+
+    // Fires on the first advance() that reaches `deadline`; deadlines
+    // already past fire on the next tick
+    void schedule(Tick deadline, T value) {
+        insert(Entry{ deadline > now_ ? deadline : now_ + 1, std::move(value) });
+        ++size_;
+    }
+
+    // Moves time forward to `now`, calling expired(T&&) for every timer due
+    template <typename F>
+    void advance(Tick now, F&& expired) {
+        while (now_ < now) {
+            ++now_;
+
+            // Pull the next stretch of each level down, highest first.
+            // Slots trade buffers with scratch_, so steady ticking does
+            // not allocate.
+            for (int level = kLevels - 1; level > 0; --level) {
+                if (now_ & levelMask(level))
+                    continue;
+                scratch_.swap(slots_[level][slotIndex(now_, level)]);
+                for (Entry& entry : scratch_)
+                    insert(std::move(entry));
+                scratch_.clear();
+            }
+
+            scratch_.swap(slots_[0][slotIndex(now_, 0)]);
+            size_ -= scratch_.size();
+            for (Entry& entry : scratch_)
+                expired(std::move(entry.value));
+            scratch_.clear();
+        }
+    }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr std::size_t kSlots = std::size_t(1) << kSlotBits;
+
+    struct Entry {
+        Tick deadline;
+        T value;
+    };
+
+    // Ticks covered by one slot of `level` is 1 << (kSlotBits * level)
+    static Tick levelMask(int level) {
+        return (Tick(1) << (kSlotBits * level)) - 1;
+    }
+
+    static std::size_t slotIndex(Tick tick, int level) {
+        return static_cast<std::size_t>(tick >> (kSlotBits * level)) & (kSlots - 1);
+    }
+
+    void insert(Entry entry) {
+        Tick delta = entry.deadline - now_;
+
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (Tick(1) << (kSlotBits * (level + 1))))
+            ++level;
+
+        // Beyond the top level: park it in the furthest top slot; it is
+        // placed again, correctly, when that slot comes down
+        Tick at = entry.deadline;
+        Tick span = Tick(1) << (kSlotBits * kLevels);
+        if (delta >= span)
+            at = now_ + span - 1;
+
+        slots_[level][slotIndex(at, level)].push_back(std::move(entry));
+    }
+
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> slots_;
+    std::vector<Entry> scratch_;
+    Tick now_;
+    std::size_t size_ = 0;
+};
+
+/* ---------------- TimerInbox ---------------- */
+
+/*
+ * Timers on their way into a TimingWheel from other threads. Any thread
+ * may push(); the wheel's owner drains the inbox into the wheel before
+ * each advance(). A push is one compare-and-swap, with no lock.
+ *
+ * Timers come out newest first; the wheel does not care.
+ */
+template <typename T>
+class TimerInbox {
+public:
+    TimerInbox() = default;
+    ~TimerInbox() { drain([](T&&) {}); }
+
+    TimerInbox(const TimerInbox&) = delete;
+    TimerInbox& operator=(const TimerInbox&) = delete;
+
+    void push(T value) {
+        Node* node = new Node{ std::move(value), head_.load(std::memory_order_relaxed) };
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    // Takes everything pushed so far, calling f(T&&) for each. One
+    // thread at a time.
+    template <typename F>
+    void drain(F&& f) {
+        Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+            Node* next = node->next;
+            f(std::move(node->value));
+            delete node;
+            node = next;
+        }
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    // On a cache line of its own, so inboxes side by side do not contend
+    alignas(64) std::atomic<Node*> head_{ nullptr };
+};
+
+#endif
@@ -1,12 +1,82 @@
 #include "networking/server_network.hpp"
+#include "engine/opening_book.hpp"
+#include "engine/transposition_table.hpp"
+#include "server_config.hpp"
 #include <boost/asio.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iostream> 
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    ServerConfig config = ServerConfig::fromArgs(argc, argv);
+
+    int ioThreads = config.ioThreads > 0
+        ? config.ioThreads
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // One table shared by every game on this server
+    TranspositionTable table(config.hashMegabytes, config.hugePages);
+
+    boost::asio::io_context io_context(ioThreads);
+
+    // Games a previous run left unfinished, and the log for this one. The
+    // log posts to the io_context's strands, so it must go first.
+    std::vector<LoggedGame> logged;
+    std::unique_ptr<MoveLog> log;
+    auto recoveryStart = std::chrono::steady_clock::now();
+
+    if (!config.logDirectory.empty()) {
+        try {
+            logged = MoveLog::recover(config.logDirectory);
+            log = std::make_unique<MoveLog>(config.logDirectory, config.logShards, logged);
+        }
+        catch (const std::exception& error) {
+            std::cerr << "Cannot open the move log: " << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<OpeningBook> book;
+    if (!config.bookPath.empty()) {
+        try {
+            book = std::make_unique<OpeningBook>(config.bookPath);
+        }
+        catch (const std::exception& error) {
+            std::cerr << "Cannot open the opening book: " << error.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Opening book " << config.bookPath << ": "
+                  << book->entries() << " entries" << std::endl;
+    }
+
+    ServerNetwork server(io_context, config.port, table, config.searchThreads,
+                         config.timeControl, config.limits, log.get(), book.get());
+
+    if (log) {
+        std::size_t restored = server.restore(logged, ioThreads);
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - recoveryStart).count();
+        std::cout << "Recovered " << restored << " games from " << config.logDirectory
+                  << " in " << millis << " ms" << std::endl;
+    }
 
-int main() {
-    boost::asio::io_context io_context;
-    ServerNetwork server(io_context, 12345);  // Port 12345
     server.start();
-    std::cout << "Server running on port 12345..." << std::endl;
+    std::cout << "Server running on port " << config.port
+              << " with " << ioThreads << " io threads..." << std::endl;
+
+    // Every thread runs the same event loop; each game's strand keeps its
+    // own events in order, so different games run in parallel
+    std::vector<std::thread> pool;
+    for (int i = 1; i < ioThreads; ++i)
+        pool.emplace_back([&io_context] { io_context.run(); });
+
     io_context.run();  // Run event loop
+
+    for (std::thread& thread : pool)
+        thread.join();
     return 0;
 }
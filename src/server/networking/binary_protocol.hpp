@@ -0,0 +1,196 @@
+#ifndef BINARY_PROTOCOL_HPP
+#define BINARY_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "chess/move.hpp"
+#include "chess/packed_position.hpp"
+
+/*
+ * Binary protocol, for bots and services.
+ *
+ * A connection starts in the text protocol and switches with the line
+ * "BINARY"; the server answers "OK BINARY\n" and from then on both sides
+ * send binary messages only. Every message starts with a one-byte type;
+ * all but Analysis have a fixed size. Integers are big-endian.
+ *
+ * A move is 16 bits laid out like Move: from square (bits 0-5), to square
+ * (bits 6-11) and flag (bits 12-15). Squares count from A8 = 0 to H1 = 63.
+ * From the client only the promotion flags (4-7) matter; the server
+ * always answers with the move as played, castling and en passant flags
+ * included.
+ *
+ * Client -> server
+ *   'M' move(2)          play a move                           3 bytes
+ *   'B'                  ask for the position                  1 byte
+ *   'A' millis(2)        analyze; 0 for the default time        3 bytes
+ *   'W' game(4)          watch a game instead of playing       5 bytes
+ *   'K' rating(2) base(2) increment(1)                         6 bytes
+ *                        seek an opponent near rating, with
+ *                        base seconds + increment seconds
+ *   'N'                  nothing; keeps an idle connection open 1 byte
+ *   'R' game(4) key(8)   take back a seat after a restart      13 bytes
+ *
+ * Server -> client
+ *   'S' color(1)         game started, you play color (0 White) 2 bytes
+ *   'M' move(2) state(1) a move was played                     4 bytes
+ *                        state: bit 0 side to move (1 Black),
+ *                        bits 1-2 GameStatus
+ *   'E' error(1)         the last request failed (Error)       2 bytes
+ *   'P' position(24)     PackedPosition                        25 bytes
+ *   'D'                  opponent disconnected, game over      1 byte
+ *   'A' length(2) text   engine analysis summary               3 + length
+ *   'C' white(4) black(4) milliseconds left on each clock       9 bytes
+ *   'F' color(1)         that side ran out of time, game over   2 bytes
+ *   'R' game(4) key(8)   key to resume this seat with after a   13 bytes
+ *                        server restart (servers with a move log)
+ *
+ * Timed games send 'C' when they start and after every move.
+ *
+ * A player resuming gets 'S' and 'P'; once both players are back, both
+ * get 'C' in a timed game and play goes on.
+ *
+ * A spectator gets 'P' when it starts watching, then the same 'M' and 'D'
+ * messages as the players. One that falls behind gets a fresh 'P'
+ * instead of the moves it missed.
+ */
+namespace binary {
+
+enum Type : std::uint8_t {
+    Start    = 'S',
+    Moved    = 'M',
+    Error    = 'E',
+    Position = 'P',
+    Left     = 'D',
+    Analysis = 'A',
+    Clocks   = 'C',
+    Flag     = 'F',
+    Key      = 'R',
+
+    // Client -> server
+    Play     = 'M',
+    Board    = 'B',
+    Analyze  = 'A',
+    Watch    = 'W',
+    Seek     = 'K',
+    Noop     = 'N',
+    Resume   = 'R'
+};
+
+enum ErrorCode : std::uint8_t {
+    BadMessage         = 1,
+    NotYourTurn        = 2,
+    NotYourPiece       = 3,
+    IllegalMove        = 4,
+    WaitingForOpponent = 5,
+    GameOver           = 6,
+    NoSuchGame         = 7,
+    Spectating         = 8, // spectators cannot move
+    Busy               = 9, // game or analysis still running; cannot watch
+                            // or analyze now
+    NotSeeking         = 10, // already matched, or watching
+    WrongKey           = 11  // no seat to resume with that key
+};
+
+// Size of a client message of this type, or 0 for an unknown type
+inline std::size_t requestSize(std::uint8_t type) {
+    switch (type) {
+        case Play:      return 3;
+        case Board:     return 1;
+        case Analyze:   return 3;
+        case Watch:     return 5;
+        case Seek:      return 6;
+        case Noop:      return 1;
+        case Resume:    return 13;
+        default:        return 0;
+    }
+}
+
+inline std::uint16_t readU16(std::string_view bytes, std::size_t at) {
+    return static_cast<std::uint16_t>(
+        static_cast<std::uint8_t>(bytes[at]) << 8 |
+        static_cast<std::uint8_t>(bytes[at + 1]));
+}
+
+inline std::uint32_t readU32(std::string_view bytes, std::size_t at) {
+    return std::uint32_t(readU16(bytes, at)) << 16 | readU16(bytes, at + 2);
+}
+
+inline std::uint64_t readU64(std::string_view bytes, std::size_t at) {
+    return std::uint64_t(readU32(bytes, at)) << 32 | readU32(bytes, at + 4);
+}
+
+inline void appendU16(std::string& out, std::uint16_t value) {
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value & 0xFF);
+}
+
+inline void appendU32(std::string& out, std::uint32_t value) {
+    appendU16(out, static_cast<std::uint16_t>(value >> 16));
+    appendU16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+}
+
+inline void appendU64(std::string& out, std::uint64_t value) {
+    appendU32(out, static_cast<std::uint32_t>(value >> 32));
+    appendU32(out, static_cast<std::uint32_t>(value & 0xFFFFFFFF));
+}
+
+/* ---- Encoders (server -> client) ---- */
+
+inline std::string start(int color) {
+    return { static_cast<char>(Start), static_cast<char>(color) };
+}
+
+inline std::string moved(Move move, int sideToMove, int status) {
+    std::string out(1, static_cast<char>(Moved));
+    appendU16(out, move.raw());
+    out += static_cast<char>(sideToMove | status << 1);
+    return out;
+}
+
+inline std::string error(ErrorCode code) {
+    return { static_cast<char>(Error), static_cast<char>(code) };
+}
+
+inline std::string position(const PackedPosition& packed) {
+    std::string out(1, static_cast<char>(Position));
+    out.append(reinterpret_cast<const char*>(packed.bytes.data()),
+               packed.bytes.size());
+    return out;
+}
+
+inline std::string left() {
+    return std::string(1, static_cast<char>(Left));
+}
+
+inline std::string clocks(std::uint32_t whiteMs, std::uint32_t blackMs) {
+    std::string out(1, static_cast<char>(Clocks));
+    appendU32(out, whiteMs);
+    appendU32(out, blackMs);
+    return out;
+}
+
+inline std::string flag(int color) {
+    return { static_cast<char>(Flag), static_cast<char>(color) };
+}
+
+inline std::string resumeKey(std::uint32_t game, std::uint64_t key) {
+    std::string out(1, static_cast<char>(Key));
+    appendU32(out, game);
+    appendU64(out, key);
+    return out;
+}
+
+inline std::string analysis(std::string_view text) {
+    std::string out(1, static_cast<char>(Analysis));
+    appendU16(out, static_cast<std::uint16_t>(text.size()));
+    out.append(text);
+    return out;
+}
+
+} // namespace binary
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef CONNECTION_LIMITS_HPP
+#define CONNECTION_LIMITS_HPP
+
+#include <chrono>
+#include <cstddef>
+
+/* ---------------- ConnectionLimits ---------------- */
+
+// What one connection, and connections together, may cost the server
+struct ConnectionLimits {
+    // Nothing received for this long closes the connection, unless it
+    // holds a seat in a game in progress; 0 = never
+    std::chrono::seconds idleTimeout{ 600 };
+
+    // A connection with more than this waiting to be sent is not reading
+    // and is closed
+    std::size_t maxQueuedBytes = 256 * 1024;
+
+    // Connections open at once; more are turned away at accept
+    int maxConnections = 10000;
+
+    // New connections accepted per second (bursts up to one second's worth)
+    int acceptsPerSecond = 500;
+
+    // ANALYZE searches run at once across the server, and requests that
+    // may wait for one; more are turned away. Each connection has at most
+    // one analysis in flight.
+    int analysisSearches = 2;
+    std::size_t analysisQueue = 32;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef FRAME_BUFFER_HPP
+#define FRAME_BUFFER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+/* ---------------- FrameBuffer ---------------- */
+
+/*
+ * Per-connection input buffer. In the text protocol a command is one
+ * line, ended by "\n" (a "\r" before it is dropped); binary messages are
+ * taken whole with unread() / consume().
+ *
+ * The buffer is allocated once with the connection and reused for every
+ * read. Reads append at the tail; nextLine() hands out each complete line
+ * as a string_view into the buffer, so a read can yield zero, one or many
+ * commands and a command may arrive over several reads. Consumed space is
+ * reclaimed by moving the unread bytes (at most one partial line) back to
+ * the front, only when the tail runs out of room.
+ */
+template <std::size_t Capacity>
+class FrameBuffer {
+public:
+    static constexpr std::size_t kCapacity = Capacity;
+
+    // Makes room at the tail before a read; invalidates earlier lines
+    void prepare() {
+        if (begin_ == end_) {
+            begin_ = end_ = 0;
+        } else if (begin_ > 0 && Capacity - end_ < Capacity / 4) {
+            std::memmove(data_.data(), data_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+    }
+
+    // Free space to read into; empty only when one line fills the buffer
+    char* writeData() { return data_.data() + end_; }
+    std::size_t writeSize() const { return Capacity - end_; }
+
+    // Marks n bytes after writeData() as received
+    void commit(std::size_t n) { end_ += n; }
+
+    // Next complete line, without its terminator. The view is valid until
+    // the next prepare().
+    bool nextLine(std::string_view& line) {
+        const char* begin = data_.data() + begin_;
+        const void* newline = std::memchr(begin, '\n', end_ - begin_);
+        if (!newline)
+            return false;
+
+        std::size_t length = static_cast<const char*>(newline) - begin;
+        begin_ += length + 1;
+
+        if (length > 0 && begin[length - 1] == '\r')
+            --length;
+        line = std::string_view(begin, length);
+        return true;
+    }
+
+    // Everything received and not yet consumed (valid until prepare())
+    std::string_view unread() const {
+        return std::string_view(data_.data() + begin_, end_ - begin_);
+    }
+    void consume(std::size_t n) { begin_ += n; }
+
+    // True when an unfinished line leaves no room to read the rest of it
+    bool overflowed() const { return end_ == Capacity && begin_ == 0; }
+
+    void clear() { begin_ = end_ = 0; }
+
+private:
+    std::array<char, Capacity> data_;
+    std::size_t begin_ = 0; // first unread byte
+    std::size_t end_ = 0;   // one past the last received byte
+};
+
+#endif
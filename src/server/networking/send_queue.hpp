@@ -0,0 +1,70 @@
+#ifndef SEND_QUEUE_HPP
+#define SEND_QUEUE_HPP
+
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* ---------------- SendQueue ---------------- */
+
+/*
+ * Outbound messages of one connection.
+ *
+ * Messages are shared, immutable strings: the queue keeps them alive until
+ * the socket is done with them, and one message broadcast to many
+ * connections is built once. At most one write is in flight. Everything
+ * queued while it runs goes out together as one gathered write, so a
+ * burst of messages costs one syscall instead of one each.
+ *
+ * Not thread-safe; the connection's strand serializes it.
+ */
+class SendQueue {
+public:
+    using Message = std::shared_ptr<const std::string>;
+
+    // Queues a message; true if no write is running and one should start
+    bool push(Message message) {
+        queuedBytes_ += message->size();
+        queued_.push_back(std::move(message));
+        return writing_.empty();
+    }
+
+    // Takes everything queued into the write that is starting now
+    const std::vector<boost::asio::const_buffer>& startWrite() {
+        writing_.swap(queued_);
+        queuedBytes_ = 0;
+
+        buffers_.clear();
+        for (const Message& message : writing_)
+            buffers_.push_back(boost::asio::buffer(*message));
+        return buffers_;
+    }
+
+    // The running write finished; true if more is queued to write next
+    bool finishWrite() {
+        writing_.clear();
+        return !queued_.empty();
+    }
+
+    bool isWriting() const { return !writing_.empty(); }
+
+    // Bytes waiting behind the write in flight
+    std::size_t queuedBytes() const { return queuedBytes_; }
+    std::size_t queuedMessages() const { return queued_.size(); }
+
+    // Drops everything that has not started writing yet
+    void clear() {
+        queued_.clear();
+        queuedBytes_ = 0;
+    }
+
+private:
+    std::vector<Message> queued_;
+    std::vector<Message> writing_;
+    std::vector<boost::asio::const_buffer> buffers_;
+    std::size_t queuedBytes_ = 0;
+};
+
+#endif
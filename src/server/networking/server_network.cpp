@@ -1,15 +1,197 @@
 #include "server_network.hpp"
 
 #include <algorithm>
-#include <sstream>
 #include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <random>
+
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+#include "binary_protocol.hpp"
+
+namespace {
+
+// ANALYZE [milliseconds]
+constexpr long kDefaultAnalysisMs = 1000;
+constexpr long kMaxAnalysisMs = 10000;
+
+// A spectator with more than this waiting to be sent has fallen behind
+constexpr std::size_t kSpectatorBacklog = 4096;
+
+// Resolution of flag fall and idle checks: the timing wheel's tick
+constexpr std::chrono::milliseconds kWheelTick{ 10 };
+
+// Accepting failed (out of file descriptors, most likely): wait this long
+constexpr std::chrono::milliseconds kAcceptBackoff{ 100 };
+
+// The matchmaker pairs its pool this often
+constexpr std::chrono::milliseconds kMatchTick{ 50 };
+
+// "CLOCK 299500 300000" (milliseconds left, White then Black), or binary
+std::string clockMessage(const Game& game, bool isBinary) {
+    auto now = ChessClock::Clock::now();
+    auto white = static_cast<std::uint32_t>(game.clock().remaining(Color::White, now).count());
+    auto black = static_cast<std::uint32_t>(game.clock().remaining(Color::Black, now).count());
+
+    if (isBinary)
+        return binary::clocks(white, black);
+    return "CLOCK " + std::to_string(white) + " " + std::to_string(black) + "\n";
+}
+
+// Splits off the next space-separated word of a command line
+std::string_view nextToken(std::string_view& rest) {
+    std::size_t start = rest.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        rest = {};
+        return {};
+    }
+    rest.remove_prefix(start);
+
+    std::size_t end = rest.find_first_of(" \t");
+    std::string_view token = rest.substr(0, end);
+    rest.remove_prefix(token.size());
+    return token;
+}
+
+// Binary error code for a move that was not played
+binary::ErrorCode errorCode(MoveOutcome outcome) {
+    switch (outcome) {
+        case MoveOutcome::NotYourTurn:        return binary::NotYourTurn;
+        case MoveOutcome::NotYourPiece:       return binary::NotYourPiece;
+        case MoveOutcome::WaitingForOpponent: return binary::WaitingForOpponent;
+        case MoveOutcome::GameOver:           return binary::GameOver;
+        default:                              return binary::IllegalMove;
+    }
+}
+
+// Dead peers are found by the kernel: probe after a minute of silence,
+// give up after three unanswered probes ten seconds apart
+void enableKeepAlive(tcp::socket& socket) {
+    boost::system::error_code ignored;
+    socket.set_option(tcp::socket::keep_alive(true), ignored);
+
+#if defined(__linux__)
+    int idle = 60, interval = 10, count = 3;
+    setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+#endif
+}
+
+// Secret for one seat of a logged game; never 0
+std::uint64_t randomKey() {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    std::uint64_t key;
+    do {
+        key = generator();
+    } while (key == 0);
+    return key;
+}
+
+std::string hexKey(std::uint64_t key) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(key));
+    return text;
+}
+
+// Commands are case-insensitive; keyword is upper case
+bool isCommand(std::string_view token, std::string_view keyword) {
+    return token.size() == keyword.size() &&
+        std::equal(token.begin(), token.end(), keyword.begin(),
+                   [](char a, char b) {
+                       return std::toupper(static_cast<unsigned char>(a)) == b;
+                   });
+}
+
+// "book e2e4 55% d2d4 30% c2c4 15% best e2e4": each book move's share of
+// the weight, heaviest first, laid out like a search summary's "best"
+std::string bookSummary(const OpeningBook::Moves& moves, std::size_t count) {
+    unsigned long total = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        total += moves[i].weight;
+
+    std::string summary = "book";
+    for (std::size_t i = 0; i < count; ++i) {
+        unsigned long percent = total > 0 ? (moves[i].weight * 100ul + total / 2) / total : 0;
+        summary += " " + moves[i].move.toString() + " " + std::to_string(percent) + "%";
+    }
+    return summary + " best " + moves[0].move.toString();
+}
+
+// The move a game has just played, as announce_move() sends it
+MoveUpdate lastUpdate(const Game& game) {
+    MoveUpdate update;
+    update.move = game.lastMove();
+    update.sideToMove = game.board().sideToMove();
+    update.status = game.status();
+    update.hash = game.board().hash();
+    return update;
+}
+
+} // namespace
 
 /* ---------------- Constructor ---------------- */
 
-ServerNetwork::ServerNetwork(boost::asio::io_context& io_context, short port)
-    : acceptor_(io_context, tcp::endpoint(tcp::v4(), port)) {
+ServerNetwork::ServerNetwork(boost::asio::io_context& io_context, short port,
+                             TranspositionTable& table, int searchThreads,
+                             const TimeControl& timeControl,
+                             const ConnectionLimits& limits,
+                             MoveLog* log,
+                             const OpeningBook* book)
+    : acceptor_(io_context, tcp::endpoint(tcp::v4(), port)),
+      table_(table),
+      timeControl_(timeControl),
+      limits_(limits),
+      log_(log),
+      book_(book),
+      acceptTimer_(io_context),
+      acceptTokens_(limits.acceptsPerSecond),
+      acceptRefill_(Clock::now()),
+      games_(table, io_context, timeControl),
+      matchTimer_(io_context),
+      wheelTimer_(io_context),
+      wheelEpoch_(Clock::now()),
+      analysis_(table, limits.analysisSearches, searchThreads, limits.analysisQueue) {
+    matchTimer_.expires_after(kMatchTick);
+    tick_matchmaking();
+
+    wheelTimer_.expires_at(wheelEpoch_);
+    tick_timers();
+}
+
+/* ---------------- Recovery ---------------- */
+
+std::size_t ServerNetwork::restore(const std::vector<LoggedGame>& logged, int threads) {
+    std::vector<std::shared_ptr<Game>> games = games_.restore(logged, threads);
+    restoredAt_ = Clock::now();
+
+    std::size_t restored = 0;
+    for (std::size_t i = 0; i < games.size(); ++i) {
+        const std::shared_ptr<Game>& game = games[i];
+
+        // A log that does not replay is no use to anyone; let it go
+        if (!game) {
+            if (log_)
+                log_->logEnd(logged[i].id);
+            continue;
+        }
+        ++restored;
+
+        // Its last move ended it, just before the crash
+        if (game->isOver()) {
+            log_end(*game);
+            games_.remove(game->id());
+            continue;
+        }
 
-    board_.initialize();
+        // Its idle checks also give up on players who do not come back
+        schedule_idle_check(game, restoredAt_ + limits_.idleTimeout);
+    }
+    return restored;
 }
 
 /* ---------------- Start Accept ---------------- */
@@ -27,72 +209,579 @@ void ServerNetwork::start() {
 
 void ServerNetwork::handle_accept(std::shared_ptr<tcp::socket> socket,
                                   const boost::system::error_code& error) {
-    if (!error) {
-        if (players_.size() < 2) {
-            Color assigned =
-                (players_.empty() ? Color::White : Color::Black);
+    if (error) {
+        // Retrying at once would spin while the process is out of fds
+        acceptTimer_.expires_after(kAcceptBackoff);
+        acceptTimer_.async_wait([this](const boost::system::error_code&) { start(); });
+        return;
+    }
 
-            players_.push_back({ socket, assigned });
+    if (connections_.load() >= limits_.maxConnections) {
+        // Say why, if the socket takes it right away, and hang up
+        static const char kFull[] = "Server full.\n";
+        boost::system::error_code ignored;
+        socket->non_blocking(true, ignored);
+        socket->write_some(boost::asio::buffer(kFull, sizeof(kFull) - 1), ignored);
+        socket->close(ignored);
+    }
+    else {
+        enableKeepAlive(*socket);
 
-            std::string welcome =
-                "Welcome! You are " +
-                std::string(assigned == Color::White ? "White" : "Black") +
-                "\n\n" + board_.display();
+        auto player = std::make_shared<Player>();
+        player->socket = socket;
+        player->slot = std::make_unique<ConnectionSlot>(connections_);
+        player->timeControl = timeControl_;
+        player->lastActive = Clock::now();
+        join_game(player);
+    }
 
-            send_to(socket, welcome);
+    accept_next();
+}
 
-            if (players_.size() == 2) {
-                broadcast(
-                    "Game started!\nWhite to move.\n\n" +
-                    board_.display()
-                );
-            }
+void ServerNetwork::accept_next() {
+    // Keep accepting, no faster than the accept rate
+    if (take_accept_token()) {
+        start();
+        return;
+    }
+    auto wait = std::chrono::duration<double>((1 - acceptTokens_) / limits_.acceptsPerSecond);
+    acceptTimer_.expires_after(std::chrono::duration_cast<Clock::duration>(wait));
+    acceptTimer_.async_wait([this](const boost::system::error_code&) { accept_next(); });
+}
+
+bool ServerNetwork::take_accept_token() {
+    if (limits_.acceptsPerSecond <= 0)
+        return true;
+
+    // A token bucket holding at most one second's worth of accepts
+    Clock::time_point now = Clock::now();
+    double rate = limits_.acceptsPerSecond;
+    acceptTokens_ = std::min(rate, acceptTokens_ +
+        rate * std::chrono::duration<double>(now - acceptRefill_).count());
+    acceptRefill_ = now;
+
+    if (acceptTokens_ < 1)
+        return false;
+    acceptTokens_ -= 1;
+    return true;
+}
+
+void ServerNetwork::join_game(std::shared_ptr<Player> player, std::string notice) {
+    std::shared_ptr<Game> game = games_.openGame();
+
+    // From here on everything about this player happens on the game's
+    // strand, until the matchmaker sends them over to an opponent's game
+    boost::asio::post(game->strand(), [this, player, game, notice = std::move(notice)] {
+        player->game = game;
+        player->color = game->seat(player);
+
+        if (!notice.empty())
+            send_to(player, notice);
+
+        send_to(player, "Welcome!\n\n" + game->board().display());
+        send_to(player, "Waiting for an opponent...\n");
+
+        seek(player);
+        schedule_idle_check(game, player->lastActive + limits_.idleTimeout);
+        read_from(player);
+    });
+}
+
+/* ---------------- Read Handler ---------------- */
+
+void ServerNetwork::read_from(std::shared_ptr<Player> player) {
+    LineBuffer& input = player->input;
+    input.prepare();
+    player->reading = true;
+
+    // A line longer than the whole buffer is not a command; drop it
+    if (input.overflowed()) {
+        input.clear();
+        send_to(player, "Line too long.\n");
+    }
+
+    player->socket->async_read_some(
+        boost::asio::buffer(input.writeData(), input.writeSize()),
+        boost::asio::bind_executor(player->game->strand(),
+            [this, player](const boost::system::error_code& ec,
+                           std::size_t bytes) {
+                handle_read(player, ec, bytes);
+            }));
+}
+
+void ServerNetwork::handle_read(std::shared_ptr<Player> player,
+                                const boost::system::error_code& error,
+                                std::size_t bytes_transferred) {
+    player->reading = false;
+
+    // Cancelled so the connection can move to another game
+    if (error && player->moving) {
+        try_switch(player);
+        return;
+    }
+
+    if (error) {
+        leave_game(player);
+        return;
+    }
+
+    if (bytes_transferred)
+        player->lastActive = Clock::now();
+
+    // One read may carry part of a command, or several of them
+    player->input.commit(bytes_transferred);
 
-            auto buffer = std::make_shared<std::vector<char>>(1024);
+    // A BINARY line switches the rest of the stream, even mid-read
+    for (;;) {
+        // Off to another game: the rest is read on its strand
+        if (player->moving) {
+            try_switch(player);
+            return;
+        }
+
+        if (player->binary) {
+            std::string_view data = player->input.unread();
+            if (data.empty())
+                break;
+
+            std::size_t size = binary::requestSize(data[0]);
+            if (size == 0) {
+                // Unknown type: framing is lost, drop what we have
+                player->input.clear();
+                send_to(player, binary::error(binary::BadMessage));
+                break;
+            }
+            if (data.size() < size)
+                break;
 
-            socket->async_read_some(boost::asio::buffer(*buffer),
-                [this, socket, buffer](const boost::system::error_code& ec,
-                                       std::size_t bytes) {
-                    handle_read(socket, buffer, ec, bytes);
-                });
+            handle_binary(player, data.substr(0, size));
+            player->input.consume(size);
         }
         else {
-            send_to(socket, "Server full. Only 2 players allowed.\n");
+            std::string_view line;
+            if (!player->input.nextLine(line))
+                break;
+            handle_command(player, line);
         }
     }
 
-    if (players_.size() < 2)
-        start();   // keep accepting until 2 players connected
+    // Re-arm async read
+    read_from(player);
 }
 
-/* ---------------- Read Handler ---------------- */
+void ServerNetwork::leave_game(const std::shared_ptr<Player>& player) {
+    std::shared_ptr<Game> game = std::move(player->game);
+    if (!game)
+        return;
 
-void ServerNetwork::handle_read(std::shared_ptr<tcp::socket> socket,
-                                std::shared_ptr<std::vector<char>> buffer,
-                                const boost::system::error_code& error,
-                                std::size_t bytes_transferred) {
-    if (error) return;
+    if (player->ticket) {
+        matchmaker_.cancel(player->ticket);
+        player->ticket = 0;
+    }
+
+    if (player->spectator) {
+        game->unwatch(player.get());
+        return;
+    }
+
+    bool wasOver = game->isOver();
+    game->leave(player->color);
+
+    // Only a game that was under way ends when someone walks out
+    if (!wasOver && game->isOver()) {
+        log_end(*game);
+
+        if (std::shared_ptr<Player> opponent = game->player(opposite(player->color)))
+            send_to(opponent, opponent->binary
+                ? binary::left()
+                : "Your opponent disconnected. Game over.\n");
+
+        auto text = std::make_shared<const std::string>(
+            std::string(player->color == Color::White ? "White" : "Black") +
+            " disconnected. Game over.\n");
+        auto left = std::make_shared<const std::string>(binary::left());
+
+        for (const auto& spectator : game->spectators())
+            send_to(spectator, spectator->binary ? left : text);
+    }
+
+    if (game->isEmpty())
+        games_.remove(game->id());
+}
+
+void ServerNetwork::close_connection(const std::shared_ptr<Player>& player) {
+    boost::system::error_code ignored;
+    player->socket->close(ignored);
+}
+
+/* ---------------- Spectators ---------------- */
+
+void ServerNetwork::watch_game(std::shared_ptr<Player> player, Game::Id id) {
+    std::shared_ptr<Game> target = games_.find(id);
+
+    if (!target) {
+        send_to(player, player->binary ? binary::error(binary::NoSuchGame)
+                                       : "No such game.\n");
+        return;
+    }
+    if (target == player->game) {
+        send_to(player, player->binary ? binary::error(binary::BadMessage)
+                                       : "You are already in that game.\n");
+        return;
+    }
+    // A game nobody has moved in yet can still be walked away from
+    const Game& current = *player->game;
+    if (!player->spectator && !current.isOver() && !current.lastMove().isNull()) {
+        send_to(player, player->binary ? binary::error(binary::Busy)
+                                       : "Finish your game before watching another.\n");
+        return;
+    }
+    if (player->analyzing) {
+        send_to(player, player->binary ? binary::error(binary::Busy)
+                                       : "Wait for your analysis before watching another game.\n");
+        return;
+    }
+
+    // handle_read() moves the connection over once this command is done
+    leave_game(player);
+    player->spectator = true;
+    player->moving = std::move(target);
+    player->output.clear();
+}
+
+/* ---------------- Resuming ---------------- */
+
+void ServerNetwork::resume_game(std::shared_ptr<Player> player, Game::Id id,
+                                std::uint64_t key) {
+    std::shared_ptr<Game> target = games_.find(id);
+
+    // The key itself is checked on the game's own strand
+    if (!target || key == 0 || target == player->game) {
+        send_to(player, player->binary ? binary::error(binary::WrongKey)
+                                       : "No seat to resume with that key.\n");
+        return;
+    }
+    const Game& current = *player->game;
+    if (!player->spectator && !current.isOver() && !current.lastMove().isNull()) {
+        send_to(player, player->binary ? binary::error(binary::Busy)
+                                       : "Finish your game before resuming another.\n");
+        return;
+    }
+    if (player->analyzing) {
+        send_to(player, player->binary ? binary::error(binary::Busy)
+                                       : "Wait for your analysis before resuming a game.\n");
+        return;
+    }
 
-    std::string input(buffer->begin(), buffer->begin() + bytes_transferred);
+    // handle_read() moves the connection over once this command is done
+    leave_game(player);
+    player->spectator = false;
+    player->resumeKey = key;
+    player->moving = std::move(target);
+    player->output.clear();
+}
 
-    // Normalize input to uppercase
-    std::transform(input.begin(), input.end(), input.begin(),
-                   [](unsigned char c){ return std::toupper(c); });
+void ServerNetwork::seat_returning(std::shared_ptr<Player> player,
+                                   const std::shared_ptr<Game>& game) {
+    std::uint64_t key = std::exchange(player->resumeKey, 0);
+    Color color = game->resumeKey(Color::White) == key ? Color::White : Color::Black;
 
-    Player* player = findPlayer(socket);
-    if (!player) return;
+    if (!game->awaitingReturn() || game->resumeKey(color) != key || game->player(color)) {
+        join_game(player, player->binary ? binary::error(binary::WrongKey)
+                                         : "No seat to resume with that key.\n");
+        return;
+    }
+
+    player->game = game;
+    player->color = color;
+    game->reseat(player, color);
 
-    if (player->color != currentTurn_) {
-        send_to(socket, "Not your turn!\n");
+    PackedPosition packed = packPosition(game->board().snapshot());
+    if (player->binary) {
+        send_to(player, binary::start(colorIndex(color)));
+        send_to(player, binary::position(packed));
+    }
+    else {
+        send_to(player, "Back in game " + std::to_string(game->id()) + " as " +
+                        (color == Color::White ? "White" : "Black") + "\n" +
+                        formatPosition(packed));
+    }
+
+    if (!game->isFull()) {
+        if (!player->binary)
+            send_to(player, "Waiting for your opponent to come back...\n");
         return;
     }
 
-    std::istringstream iss(input);
-    std::string command, from, to;
-    iss >> command >> from >> to;
+    // Both back: the clock runs again from where it stopped
+    auto resumed = std::make_shared<const std::string>("Game resumed!\n");
+    for (Color seat : { Color::White, Color::Black })
+        if (const auto& p = game->player(seat); !p->binary)
+            send_to(p, resumed);
+    for (const auto& spectator : game->spectators())
+        if (!spectator->binary)
+            send_to(spectator, resumed);
+
+    announce_clocks(*game);
+    schedule_flag(game);
+}
+
+void ServerNetwork::abandon_game(const std::shared_ptr<Game>& game) {
+    for (Color color : { Color::White, Color::Black })
+        if (!game->player(color))
+            game->leave(color);
+    log_end(*game);
+
+    auto left = std::make_shared<const std::string>(binary::left());
+    for (Color color : { Color::White, Color::Black })
+        if (const auto& p = game->player(color))
+            send_to(p, p->binary ? left : std::make_shared<const std::string>(
+                "Your opponent did not come back. Game over.\n"));
+
+    auto text = std::make_shared<const std::string>("A player did not come back. Game over.\n");
+    for (const auto& spectator : game->spectators())
+        send_to(spectator, spectator->binary ? left : text);
+
+    if (game->isEmpty())
+        games_.remove(game->id());
+}
+
+void ServerNetwork::log_end(const Game& game) {
+    if (log_)
+        log_->logEnd(game.id());
+}
 
-    if (command != "MOVE" || from.size() != 2 || to.size() != 2) {
-        send_to(socket, "Invalid command. Use: MOVE A2 A4\n");
+/* ---------------- Switching games ---------------- */
+
+void ServerNetwork::try_switch(const std::shared_ptr<Player>& player) {
+    // Nothing may complete on the old strand once the player has moved.
+    // Whichever of these is still running tries again when it is done.
+    if (player->output.isWriting())
+        return;
+    if (player->reading) {
+        player->socket->cancel();
+        return;
+    }
+    switch_game(player);
+}
+
+void ServerNetwork::switch_game(std::shared_ptr<Player> player) {
+    std::shared_ptr<Game> game = std::move(player->moving);
+
+    boost::asio::post(game->strand(), [this, player, game] {
+        if (player->spectator) {
+            player->game = game;
+            game->watch(player);
+
+            PackedPosition packed = packPosition(game->board().snapshot());
+            if (player->binary)
+                send_to(player, binary::position(packed));
+            else
+                send_to(player, "Watching game " + std::to_string(game->id()) +
+                                "\n" + formatPosition(packed));
+
+            if (game->clock().running())
+                send_to(player, clockMessage(*game, player->binary));
+        }
+        else if (player->resumeKey) {
+            seat_returning(player, game);
+            if (!player->game)
+                return;  // off to a game of its own instead
+        }
+        else {
+            // The host left while this player was on the way
+            const std::shared_ptr<Player>& host = game->player(Color::White);
+            if (!host || game->isFull() || game->isOver()) {
+                join_game(player);
+                return;
+            }
+
+            // The host may have sought again in the meantime
+            matchmaker_.cancel(host->ticket);
+            host->ticket = 0;
+
+            player->game = game;
+            player->color = game->seat(player);
+
+            // Keys to take the seats back should the server restart
+            if (log_) {
+                game->setResumeKeys(randomKey(), randomKey());
+                log_->logStart(game->id(), game->clock().control(),
+                               game->resumeKey(Color::White),
+                               game->resumeKey(Color::Black));
+            }
+            announce_start(*game);
+            schedule_flag(game);
+        }
+
+        // Commands that arrived before the move, then back to reading
+        handle_read(player, {}, 0);
+    });
+}
+
+/* ---------------- Matchmaking ---------------- */
+
+void ServerNetwork::seek(const std::shared_ptr<Player>& player) {
+    matchmaker_.cancel(player->ticket);
+    player->game->setTimeControl(player->timeControl);
+
+    Seeker seeker;
+    seeker.player = player;
+    seeker.game = player->game;
+    seeker.rating = player->rating;
+    seeker.timeControl = player->timeControl;
+    seeker.since = Matchmaker::Clock::now();
+    player->ticket = matchmaker_.enqueue(std::move(seeker));
+}
+
+void ServerNetwork::requeue(Seeker seeker) {
+    std::shared_ptr<Game> game = seeker.game;
+
+    // Back in the pool with the wait so far still counting, unless the
+    // player left or sought again
+    boost::asio::post(game->strand(), [this, seeker = std::move(seeker)]() mutable {
+        std::shared_ptr<Player> player = seeker.player;
+        if (player->ticket == seeker.ticket)
+            player->ticket = matchmaker_.enqueue(std::move(seeker));
+    });
+}
+
+void ServerNetwork::start_match(Match match) {
+    std::shared_ptr<Game> lobby = match.guest.game;
+
+    // The guest moves to the host's game, starting from its own strand
+    boost::asio::post(lobby->strand(), [this, match = std::move(match)]() mutable {
+        std::shared_ptr<Player> guest = match.guest.player;
+
+        // Left, or sought again, since the pool was paired
+        if (guest->ticket != match.guest.ticket) {
+            requeue(std::move(match.host));
+            return;
+        }
+
+        // An analysis would report back to this strand after the move
+        if (guest->analyzing) {
+            requeue(std::move(match.host));
+            requeue(std::move(match.guest));
+            return;
+        }
+
+        guest->ticket = 0;
+        leave_game(guest);
+        guest->moving = std::move(match.host.game);
+        try_switch(guest);
+    });
+}
+
+void ServerNetwork::tick_matchmaking() {
+    matchTimer_.async_wait([this](const boost::system::error_code& error) {
+        if (error)
+            return;
+
+        matchmaker_.tick(Matchmaker::Clock::now(), matches_);
+        for (Match& match : matches_)
+            start_match(std::move(match));
+        matches_.clear();
+
+        matchTimer_.expires_at(matchTimer_.expiry() + kMatchTick);
+        tick_matchmaking();
+    });
+}
+
+/* ---------------- Commands ---------------- */
+
+void ServerNetwork::handle_command(std::shared_ptr<Player> player,
+                                   std::string_view input) {
+    std::string_view command = nextToken(input);
+    std::string_view from = nextToken(input);
+    std::string_view to = nextToken(input);
+
+    Game& game = *player->game;
+
+    if (command.empty())
+        return;
+
+    // Analysis is allowed at any time, by either player
+    if (isCommand(command, "ANALYZE")) {
+        long millis = 0;
+        std::from_chars(from.data(), from.data() + from.size(), millis);
+        handle_analyze(player, millis);
+        return;
+    }
+
+    // Full position, for a client whose board went out of step. BOARD <id>
+    // shows any other game, say before watching it; that board belongs to
+    // another strand, so it is read from the game's published snapshot.
+    if (isCommand(command, "BOARD")) {
+        if (from.empty()) {
+            send_to(player, formatPosition(packPosition(game.board().snapshot())));
+            return;
+        }
+        Game::Id id = 0;
+        std::from_chars(from.data(), from.data() + from.size(), id);
+        std::shared_ptr<Game> other = games_.find(id);
+        send_to(player, other ? formatPosition(packPosition(other->snapshots().read()))
+                              : "No such game.\n");
+        return;
+    }
+
+    if (isCommand(command, "SEEK")) {
+        int rating = 0;
+        std::from_chars(from.data(), from.data() + from.size(), rating);
+
+        TimeControl control = player->timeControl;
+        if (rating <= 0 || (!to.empty() && !parseTimeControl(to, control))) {
+            send_to(player, "Use: SEEK <rating> [minutes+increment]\n");
+            return;
+        }
+        if (!player->ticket) {
+            send_to(player, "You are not waiting for a game.\n");
+            return;
+        }
+
+        player->rating = rating;
+        player->timeControl = control;
+        seek(player);
+        send_to(player, "Seeking an opponent near " + std::to_string(rating) + "...\n");
+        return;
+    }
+
+    if (isCommand(command, "STATS")) {
+        Matchmaker::Stats stats = matchmaker_.stats();
+        send_to(player, "MATCHMAKING waiting " + std::to_string(stats.waiting) +
+                        " matches " + std::to_string(stats.matches) +
+                        " p50 " + std::to_string(stats.p50.count()) + "ms" +
+                        " p90 " + std::to_string(stats.p90.count()) + "ms" +
+                        " p99 " + std::to_string(stats.p99.count()) + "ms" +
+                        " max " + std::to_string(stats.max.count()) + "ms\n");
+        return;
+    }
+
+    if (isCommand(command, "WATCH")) {
+        Game::Id id = 0;
+        std::from_chars(from.data(), from.data() + from.size(), id);
+        watch_game(player, id);
+        return;
+    }
+
+    if (isCommand(command, "RESUME")) {
+        Game::Id id = 0;
+        std::uint64_t key = 0;
+        std::from_chars(from.data(), from.data() + from.size(), id);
+        std::from_chars(to.data(), to.data() + to.size(), key, 16);
+        resume_game(player, id, key);
+        return;
+    }
+
+    // Everything after this line is binary, both ways
+    if (isCommand(command, "BINARY")) {
+        send_to(player, "OK BINARY\n");
+        player->binary = true;
+        return;
+    }
+
+    if (!isCommand(command, "MOVE") || from.size() != 2 || to.size() != 2) {
+        send_to(player, "Invalid command. Use: MOVE A2 A4\n");
         return;
     }
 
@@ -100,58 +789,444 @@ void ServerNetwork::handle_read(std::shared_ptr<tcp::socket> socket,
     auto [tx, ty] = parseAlgebraic(to);
 
     if (fx < 0 || fy < 0 || tx < 0 || ty < 0) {
-        send_to(socket, "Invalid coordinates.\n");
+        send_to(player, "Invalid coordinates.\n");
         return;
     }
 
-    if (board_.movePiece(fx, fy, tx, ty)) {
-        currentTurn_ =
-            (currentTurn_ == Color::White ? Color::Black : Color::White);
+    play_move(player, fx, fy, tx, ty, PieceType::Queen);
+}
 
-        broadcast(
-            "Move successful!\n" +
-            std::string(currentTurn_ == Color::White ? "White" : "Black") +
-            " to move.\n\n" +
-            board_.display()
-        );
+void ServerNetwork::handle_binary(std::shared_ptr<Player> player,
+                                  std::string_view message) {
+    switch (static_cast<std::uint8_t>(message[0])) {
+        case binary::Play: {
+            Move move = Move::fromRaw(binary::readU16(message, 1));
+            PieceType promotion = move.isPromotion() ? move.promotion()
+                                                     : PieceType::Queen;
+            play_move(player,
+                      squareX(move.from()), squareY(move.from()),
+                      squareX(move.to()), squareY(move.to()), promotion);
+            break;
+        }
+
+        case binary::Board:
+            send_to(player, binary::position(
+                packPosition(player->game->board().snapshot())));
+            break;
+
+        case binary::Analyze:
+            handle_analyze(player, binary::readU16(message, 1));
+            break;
+
+        case binary::Watch:
+            watch_game(player, binary::readU32(message, 1));
+            break;
+
+        case binary::Noop:
+            break;
+
+        case binary::Resume:
+            resume_game(player, binary::readU32(message, 1), binary::readU64(message, 5));
+            break;
+
+        case binary::Seek:
+            if (!player->ticket) {
+                send_to(player, binary::error(binary::NotSeeking));
+                break;
+            }
+            player->rating = binary::readU16(message, 1);
+            player->timeControl.base = std::chrono::seconds(binary::readU16(message, 3));
+            player->timeControl.increment =
+                std::chrono::seconds(static_cast<std::uint8_t>(message[5]));
+            seek(player);
+            break;
     }
-    else {
-        send_to(socket,
-            "Invalid move! Try again.\n\n" + board_.display());
+}
+
+void ServerNetwork::play_move(std::shared_ptr<Player> player,
+                              int fx, int fy, int tx, int ty,
+                              PieceType promotion) {
+    if (player->spectator) {
+        send_to(player, player->binary ? binary::error(binary::Spectating)
+                                       : "Spectators cannot move.\n");
+        return;
     }
 
-    // Re-arm async read
-    auto newBuffer = std::make_shared<std::vector<char>>(1024);
-    socket->async_read_some(boost::asio::buffer(*newBuffer),
-        [this, socket, newBuffer](const boost::system::error_code& ec,
-                                  std::size_t bytes) {
-            handle_read(socket, newBuffer, ec, bytes);
+    Game& game = *player->game;
+    MoveOutcome outcome = game.play(player->color, fx, fy, tx, ty, promotion);
+
+    if (outcome == MoveOutcome::Played && log_) {
+        // Nobody hears of the move until it is on disk; moves logged
+        // meanwhile by other games share the same sync. The game may play
+        // on before then, so the announcement is taken now.
+        std::shared_ptr<Game> shared = player->game;
+        MoveUpdate update = lastUpdate(game);
+        BoardSnapshot position = game.board().snapshot();
+        log_->logMove(game.id(), update.move,
+                      game.clock().remaining(player->color, Clock::now()),
+                      [this, shared, update, position] {
+                          boost::asio::post(shared->strand(), [this, shared, update, position] {
+                              announce_move(*shared, update, position);
+                              schedule_flag(shared);
+                          });
+                      });
+        if (game.isOver())
+            log_end(game);
+        return;
+    }
+
+    if (outcome == MoveOutcome::Played) {
+        announce_move(game, lastUpdate(game), game.board().snapshot());
+        schedule_flag(player->game);
+        return;
+    }
+
+    if (outcome == MoveOutcome::OutOfTime) {
+        log_end(game);
+        announce_flag(game);
+        return;
+    }
+
+    if (player->binary) {
+        send_to(player, binary::error(errorCode(outcome)));
+        return;
+    }
+
+    switch (outcome) {
+        case MoveOutcome::NotYourTurn:
+            send_to(player, "Not your turn!\n");
+            break;
+        case MoveOutcome::NotYourPiece:
+            send_to(player, "That is not your piece!\n");
+            break;
+        case MoveOutcome::WaitingForOpponent:
+            send_to(player, "Waiting for an opponent...\n");
+            break;
+        case MoveOutcome::GameOver:
+            send_to(player, "The game is over.\n");
+            break;
+        default:
+            send_to(player, "Invalid move! Try again.\n");
+            break;
+    }
+}
+
+/* ---------------- Announcements ---------------- */
+
+void ServerNetwork::announce_start(const Game& game) {
+    for (Color color : { Color::White, Color::Black }) {
+        const auto& p = game.player(color);
+        if (!p)
+            continue;
+
+        if (p->binary)
+            send_to(p, binary::start(colorIndex(color)));
+        else
+            send_to(p, "You are " +
+                       std::string(color == Color::White ? "White" : "Black") +
+                       " in game " + std::to_string(game.id()) +
+                       "\nGame started!\nWhite to move.\n");
+
+        if (std::uint64_t key = game.resumeKey(color)) {
+            send_to(p, p->binary
+                ? binary::resumeKey(static_cast<std::uint32_t>(game.id()), key)
+                : "If the server restarts, come back with: RESUME " +
+                  std::to_string(game.id()) + " " + hexKey(key) + "\n");
+        }
+    }
+
+    // Binary spectators learn of the start from the first move
+    auto started = std::make_shared<const std::string>("Game started!\nWhite to move.\n");
+    for (const auto& spectator : game.spectators())
+        if (!spectator->binary)
+            send_to(spectator, started);
+
+    announce_clocks(game);
+}
+
+void ServerNetwork::announce_move(const Game& game, const MoveUpdate& update,
+                                  const BoardSnapshot& position) {
+    // Only the move goes out; clients play it on their own board and
+    // check the key (move_update.hpp)
+
+    // Each encoding is built once, the first time someone needs it, and
+    // shared by everyone who gets it
+    SendQueue::Message moveText, moveBinary, positionText, positionBinary;
+
+    auto moveFor = [&](const Player& p) {
+        SendQueue::Message& message = p.binary ? moveBinary : moveText;
+        if (!message) {
+            message = std::make_shared<const std::string>(p.binary
+                ? binary::moved(update.move, colorIndex(update.sideToMove),
+                                static_cast<int>(update.status))
+                : formatMoveUpdate(update));
+        }
+        return message;
+    };
+
+    auto positionFor = [&](const Player& p) {
+        SendQueue::Message& message = p.binary ? positionBinary : positionText;
+        if (!message) {
+            PackedPosition packed = packPosition(position);
+            message = std::make_shared<const std::string>(p.binary
+                ? binary::position(packed)
+                : formatPosition(packed));
+        }
+        return message;
+    };
+
+    for (Color color : { Color::White, Color::Black })
+        if (const auto& p = game.player(color))
+            send_to(p, moveFor(*p));
+
+    // A spectator that cannot keep up loses its backlog and skips to the
+    // position after this move, so a slow reader holds a few kilobytes at
+    // most instead of every move it has not taken yet
+    for (const auto& spectator : game.spectators()) {
+        if (spectator->output.queuedBytes() > kSpectatorBacklog) {
+            spectator->output.clear();
+            send_to(spectator, positionFor(*spectator));
+        }
+        else {
+            send_to(spectator, moveFor(*spectator));
+        }
+    }
+
+    announce_clocks(game);
+}
+
+void ServerNetwork::announce_clocks(const Game& game) {
+    if (!game.clock().control().enabled())
+        return;
+
+    send_all(game,
+             std::make_shared<const std::string>(clockMessage(game, false)),
+             std::make_shared<const std::string>(clockMessage(game, true)));
+}
+
+void ServerNetwork::announce_flag(const Game& game) {
+    Color loser = game.board().sideToMove();
+    std::string text = std::string(loser == Color::White ? "White" : "Black") +
+                       " ran out of time. " +
+                       (loser == Color::White ? "Black" : "White") + " wins.\n";
+
+    send_all(game,
+             std::make_shared<const std::string>(std::move(text)),
+             std::make_shared<const std::string>(binary::flag(colorIndex(loser))));
+}
+
+void ServerNetwork::send_all(const Game& game,
+                             const SendQueue::Message& textMessage,
+                             const SendQueue::Message& binaryMessage) {
+    for (Color color : { Color::White, Color::Black })
+        if (const auto& p = game.player(color))
+            send_to(p, p->binary ? binaryMessage : textMessage);
+
+    for (const auto& spectator : game.spectators())
+        send_to(spectator, spectator->binary ? binaryMessage : textMessage);
+}
+
+/* ---------------- Timers ---------------- */
+
+std::uint64_t ServerNetwork::wheel_tick(Clock::time_point when) const {
+    // Round up: a timer must not fire before its time
+    Clock::duration since = when - wheelEpoch_;
+    return static_cast<std::uint64_t>(
+        (since + kWheelTick - Clock::duration(1)) / kWheelTick);
+}
+
+void ServerNetwork::schedule_timer(const std::shared_ptr<Game>& game,
+                                   GameTimer::Kind kind, std::uint64_t tick) {
+    // Games spread over the inboxes, so strands seldom push to the same one
+    auto& inbox = timerInboxes_[game->id() % kTimerInboxes];
+    inbox.push({ tick, GameTimer{ kind, game } });
+}
+
+void ServerNetwork::schedule_flag(const std::shared_ptr<Game>& game) {
+    if (!game->clock().running())
+        return;
+
+    // The timer set for the previous move stays in the wheel; when it
+    // fires, checkFlag() finds the clock has moved on and does nothing
+    schedule_timer(game, GameTimer::Flag, wheel_tick(game->clock().flagTime()));
+}
+
+void ServerNetwork::schedule_idle_check(const std::shared_ptr<Game>& game,
+                                        Clock::time_point when) {
+    if (limits_.idleTimeout.count() == 0)
+        return;
+
+    schedule_timer(game, GameTimer::Idle, wheel_tick(when));
+}
+
+void ServerNetwork::check_idle(const std::shared_ptr<Game>& game) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point next = now + limits_.idleTimeout;
+    bool anyone = false;
+
+    // A recovered game waits as long for its players to come back
+    if (game->awaitingReturn()) {
+        Clock::time_point deadline = restoredAt_ + limits_.idleTimeout;
+        if (deadline <= now) {
+            abandon_game(game);
+        }
+        else {
+            anyone = true;
+            next = std::min(next, deadline);
+        }
+    }
+
+    auto check = [&](const std::shared_ptr<Player>& p) {
+        anyone = true;
+        Clock::time_point deadline = p->lastActive + limits_.idleTimeout;
+        if (deadline <= now)
+            close_connection(p);
+        else
+            next = std::min(next, deadline);
+    };
+
+    // Players in a game under way are waiting on their opponent, not
+    // idle; keepalive still finds the dead ones
+    bool underWay = game->isFull() && !game->isOver();
+    for (Color color : { Color::White, Color::Black }) {
+        if (const auto& p = game->player(color)) {
+            if (underWay)
+                anyone = true;
+            else
+                check(p);
+        }
+    }
+    for (const auto& spectator : game->spectators())
+        check(spectator);
+
+    // One check per game at a time, for as long as it has connections
+    if (anyone)
+        schedule_idle_check(game, next);
+}
+
+void ServerNetwork::tick_timers() {
+    wheelTimer_.expires_at(wheelTimer_.expiry() + kWheelTick);
+    wheelTimer_.async_wait([this](const boost::system::error_code& error) {
+        if (error)
+            return;
+
+        auto now = static_cast<std::uint64_t>((Clock::now() - wheelEpoch_) / kWheelTick);
+        // Timers armed since the last tick go in first, so one already
+        // due fires now, as it would have if armed straight into the wheel
+        for (auto& inbox : timerInboxes_) {
+            inbox.drain([this](std::pair<std::uint64_t, GameTimer>&& timer) {
+                timers_.schedule(timer.first, std::move(timer.second));
+            });
+        }
+        timers_.advance(now, [this](GameTimer&& timer) {
+            if (std::shared_ptr<Game> game = timer.game.lock())
+                timersDue_.emplace_back(timer.kind, std::move(game));
+        });
+
+        // Each game looks at its own clock and connections on its strand
+        for (auto& [kind, game] : timersDue_) {
+            boost::asio::post(game->strand(), [this, kind = kind, game = game] {
+                if (kind == GameTimer::Idle) {
+                    check_idle(game);
+                }
+                else if (game->checkFlag()) {
+                    log_end(*game);
+                    announce_flag(*game);
+                }
+            });
+        }
+        timersDue_.clear();
+
+        tick_timers();
+    });
+}
+
+void ServerNetwork::handle_analyze(std::shared_ptr<Player> player, long millis) {
+    SearchLimits limits;
+    limits.time = std::chrono::milliseconds(
+        millis > 0 ? std::min(millis, kMaxAnalysisMs) : kDefaultAnalysisMs);
+
+    // Book positions are answered at once, without a search
+    if (book_) {
+        OpeningBook::Moves moves;
+        if (std::size_t count = book_->lookup(player->game->board(), moves)) {
+            std::string summary = bookSummary(moves, count);
+            send_to(player, player->binary ? binary::analysis(summary)
+                                           : "Analysis: " + summary + "\n");
+            return;
+        }
+    }
+
+    // One analysis in flight per connection
+    if (player->analyzing > 0) {
+        send_to(player, player->binary ? binary::error(binary::Busy)
+                                       : "Still analyzing the last position.\n");
+        return;
+    }
+
+    // Search a copy of the board in the shared pool, then hand the report
+    // back to the game's strand. A full queue turns the request away.
+    auto executor = player->game->strand();
+    bool queued = analysis_.submit(player->game->board(), limits,
+        [this, player, executor](const SearchResult& result) {
+            // Back on the strand before looking at the player again
+            boost::asio::post(executor, [this, player, summary = result.summary()] {
+                --player->analyzing;
+                send_to(player, player->binary
+                    ? binary::analysis(summary)
+                    : "Analysis: " + summary + "\n");
+            });
         });
+    if (!queued) {
+        send_to(player, player->binary ? binary::error(binary::Busy)
+                                       : "The engine is busy; try again later.\n");
+        return;
+    }
+
+    ++player->analyzing;
+    if (!player->binary)
+        send_to(player, "Analyzing...\n");
 }
 
 /* ---------------- Helpers ---------------- */
 
-void ServerNetwork::send_to(std::shared_ptr<tcp::socket> socket,
-                            const std::string& message) {
-    boost::asio::async_write(*socket,
-        boost::asio::buffer(message),
-        [](const boost::system::error_code&, std::size_t) {});
+void ServerNetwork::send_to(const std::shared_ptr<Player>& player,
+                            std::string message) {
+    send_to(player, std::make_shared<const std::string>(std::move(message)));
 }
 
-void ServerNetwork::broadcast(const std::string& message) {
-    for (auto& p : players_)
-        send_to(p.socket, message);
+void ServerNetwork::send_to(const std::shared_ptr<Player>& player,
+                            SendQueue::Message message) {
+    // Gone from its game: the connection is closing, nothing to say
+    if (!player->game)
+        return;
+
+    // Not reading what it is sent: cut it off before the backlog grows
+    if (player->output.queuedBytes() + message->size() > limits_.maxQueuedBytes) {
+        close_connection(player);
+        return;
+    }
+
+    if (player->output.push(std::move(message)))
+        write_to(player);
 }
 
-Player* ServerNetwork::findPlayer(std::shared_ptr<tcp::socket> socket) {
-    for (auto& p : players_)
-        if (p.socket == socket)
-            return &p;
-    return nullptr;
+void ServerNetwork::write_to(std::shared_ptr<Player> player) {
+    // Everything queued so far leaves in one gathered write
+    boost::asio::async_write(*player->socket, player->output.startWrite(),
+        boost::asio::bind_executor(player->game->strand(),
+            [this, player](const boost::system::error_code& error, std::size_t) {
+                bool more = player->output.finishWrite();
+
+                if (player->moving)
+                    try_switch(player);
+                else if (more && !error && player->game)
+                    write_to(player);
+            }));
 }
 
-std::pair<int,int> ServerNetwork::parseAlgebraic(const std::string& pos) const {
-    int x = pos[0] - 'A';        // A–H → 0–7
+std::pair<int,int> ServerNetwork::parseAlgebraic(std::string_view pos) const {
+    int x = std::toupper(static_cast<unsigned char>(pos[0])) - 'A'; // A–H → 0–7
     int y = 8 - (pos[1] - '0');  // 1–8 → 7–0
 
     if (x < 0 || x > 7 || y < 0 || y > 7)
@@ -1,55 +1,237 @@
 #ifndef SERVER_NETWORK_HPP
 #define SERVER_NETWORK_HPP
 
+#include <array>
+#include <atomic>
 #include <boost/asio.hpp>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "chess/chess_board.hpp"
+#include "chess/move_update.hpp"
+#include "engine/analysis_pool.hpp"
+#include "engine/opening_book.hpp"
+#include "engine/transposition_table.hpp"
+#include "game/game_registry.hpp"
+#include "game/matchmaker.hpp"
+#include "game/move_log.hpp"
+#include "game/timing_wheel.hpp"
+#include "connection_limits.hpp"
+#include "frame_buffer.hpp"
+#include "send_queue.hpp"
 
 using boost::asio::ip::tcp;
 
 /* ---------------- Player ---------------- */
 
+// Holds one place under the connection limit while it lives
+class ConnectionSlot {
+public:
+    explicit ConnectionSlot(std::atomic<int>& open) : open_(open) { ++open_; }
+    ~ConnectionSlot() { --open_; }
+
+    ConnectionSlot(const ConnectionSlot&) = delete;
+    ConnectionSlot& operator=(const ConnectionSlot&) = delete;
+
+private:
+    std::atomic<int>& open_;
+};
+
+// Longest command line a client may send
+using LineBuffer = FrameBuffer<512>;
+
+// One connection: a seat in a game, or a place in its audience
 struct Player {
     std::shared_ptr<tcp::socket> socket;
-    Color color;
+    std::unique_ptr<ConnectionSlot> slot;
+    Color color = Color::White;
+    std::shared_ptr<Game> game;
+
+    // Watching `game` rather than playing in it
+    bool spectator = false;
+
+    // What the player asked the matchmaker for, and their place in its
+    // pool while they wait (0 once matched)
+    int rating = 1500;
+    TimeControl timeControl;
+    Matchmaker::Ticket ticket = 0;
+
+    // Game to move to next, to play or to watch, once nothing is left in
+    // flight on the old game's strand
+    std::shared_ptr<Game> moving;
+    bool reading = false;
+
+    // Key for a seat in `moving`, when it is a game recovered from the log
+    std::uint64_t resumeKey = 0;
+
+    // Analyses whose reports will come back on this game's strand
+    int analyzing = 0;
+
+    // Bytes received but not yet parsed into commands
+    LineBuffer input;
+
+    // Last time anything arrived; idle connections are closed
+    std::chrono::steady_clock::time_point lastActive;
+
+    // Messages on their way out, one write at a time
+    SendQueue output;
+
+    // Switched to the binary protocol (binary_protocol.hpp)
+    bool binary = false;
 };
 
 /* ------------- ServerNetwork ------------ */
 
 class ServerNetwork {
 public:
-    ServerNetwork(boost::asio::io_context& io_context, short port);
+    ServerNetwork(boost::asio::io_context& io_context, short port,
+                  TranspositionTable& table, int searchThreads = 1,
+                  const TimeControl& timeControl = {},
+                  const ConnectionLimits& limits = {},
+                  MoveLog* log = nullptr,
+                  const OpeningBook* book = nullptr);
     void start();
 
+    // The port it listens on (the one the system picked, given port 0)
+    unsigned short port() const { return acceptor_.local_endpoint().port(); }
+
+    // Brings back the games a move log left unfinished, replaying them on
+    // `threads` threads; before start(). Returns how many came back.
+    std::size_t restore(const std::vector<LoggedGame>& logged, int threads = 1);
+
 private:
     // Networking
     void handle_accept(std::shared_ptr<tcp::socket> socket,
                        const boost::system::error_code& error);
+    void accept_next();
+    bool take_accept_token();
+
+    // A game of its own to wait in; `notice` goes out before the welcome
+    void join_game(std::shared_ptr<Player> player, std::string notice = {});
+    void read_from(std::shared_ptr<Player> player);
 
-    void handle_read(std::shared_ptr<tcp::socket> socket,
-                     std::shared_ptr<std::vector<char>> buffer,
+    void handle_read(std::shared_ptr<Player> player,
                      const boost::system::error_code& error,
                      std::size_t bytes_transferred);
 
-    void send_to(std::shared_ptr<tcp::socket> socket,
-                 const std::string& message);
+    // Gives up the seat or the place in the audience
+    void leave_game(const std::shared_ptr<Player>& player);
+
+    // Drops the connection; its pending read fails and it leaves its game
+    void close_connection(const std::shared_ptr<Player>& player);
+
+    // Spectators
+    void watch_game(std::shared_ptr<Player> player, Game::Id id);
 
-    void broadcast(const std::string& message);
+    // Back to a seat in a game recovered from the log
+    void resume_game(std::shared_ptr<Player> player, Game::Id id, std::uint64_t key);
+    void seat_returning(std::shared_ptr<Player> player, const std::shared_ptr<Game>& game);
+
+    // Recovered game whose players did not all come back in time
+    void abandon_game(const std::shared_ptr<Game>& game);
+
+    // Records that a game is over, so a restart leaves it be
+    void log_end(const Game& game);
+
+    // Moving a connection to another game's strand
+    void try_switch(const std::shared_ptr<Player>& player);
+    void switch_game(std::shared_ptr<Player> player);
+
+    // Matchmaking: every waiting player is in the pool, paired on a tick
+    void seek(const std::shared_ptr<Player>& player);
+    void requeue(Seeker seeker);
+    void start_match(Match match);
+    void tick_matchmaking();
+
+    // Commands
+    void handle_command(std::shared_ptr<Player> player,
+                        std::string_view input);
+
+    void handle_binary(std::shared_ptr<Player> player,
+                       std::string_view message);
+
+    void handle_analyze(std::shared_ptr<Player> player, long millis);
+
+    void play_move(std::shared_ptr<Player> player,
+                   int fx, int fy, int tx, int ty, PieceType promotion);
+
+    // Tell both players and every spectator, each in their own protocol
+    void announce_start(const Game& game);
+    // The move and the position it left, as they were when it was played;
+    // the game itself may have moved on by the time they go out
+    void announce_move(const Game& game, const MoveUpdate& update,
+                       const BoardSnapshot& position);
+    void announce_clocks(const Game& game);
+    void announce_flag(const Game& game);
+
+    void send_all(const Game& game, const SendQueue::Message& textMessage,
+                  const SendQueue::Message& binaryMessage);
+
+    void send_to(const std::shared_ptr<Player>& player, std::string message);
+    void send_to(const std::shared_ptr<Player>& player, SendQueue::Message message);
+    void write_to(std::shared_ptr<Player> player);
+
+    // What a game's timer in the wheel is for
+    struct GameTimer {
+        enum Kind { Flag, Idle } kind;
+        std::weak_ptr<Game> game;
+    };
+
+    // One timing wheel watches every game's flag and idle connections
+    void schedule_timer(const std::shared_ptr<Game>& game, GameTimer::Kind kind,
+                        std::uint64_t tick);
+    void schedule_flag(const std::shared_ptr<Game>& game);
+    void schedule_idle_check(const std::shared_ptr<Game>& game,
+                             std::chrono::steady_clock::time_point when);
+    void check_idle(const std::shared_ptr<Game>& game);
+    void tick_timers();
+    std::uint64_t wheel_tick(std::chrono::steady_clock::time_point when) const;
 
     // Game helpers
-    std::pair<int,int> parseAlgebraic(const std::string& pos) const;
-    Player* findPlayer(std::shared_ptr<tcp::socket> socket);
+    std::pair<int,int> parseAlgebraic(std::string_view pos) const;
 
 private:
     tcp::acceptor acceptor_;
+    TranspositionTable& table_;
+    TimeControl timeControl_;
+    ConnectionLimits limits_;
+    MoveLog* log_;
+    const OpeningBook* book_;
+
+    // Accept rate (token bucket) and open connections
+    boost::asio::steady_timer acceptTimer_;
+    double acceptTokens_;
+    std::chrono::steady_clock::time_point acceptRefill_;
+    std::atomic<int> connections_{ 0 };
+
+    GameRegistry games_;
+
+    Matchmaker matchmaker_;
+    boost::asio::steady_timer matchTimer_;
+    std::vector<Match> matches_;
+
+    using Clock = ChessClock::Clock;
+
+    // Strands hand their timers to the wheel through the inboxes, one per
+    // few games, and only the tick ever touches the wheel itself
+    static constexpr std::size_t kTimerInboxes = 16;
+
+    boost::asio::steady_timer wheelTimer_;
+    Clock::time_point wheelEpoch_;
+    std::array<TimerInbox<std::pair<std::uint64_t, GameTimer>>, kTimerInboxes> timerInboxes_;
+    TimingWheel<GameTimer> timers_;
+    std::vector<std::pair<GameTimer::Kind, std::shared_ptr<Game>>> timersDue_;
+
+    // Players of recovered games have until idleTimeout after this
+    Clock::time_point restoredAt_;
 
-    ChessBoard board_;
-    std::vector<Player> players_;   // max 2
-    Color currentTurn_ = Color::White;
+    // Engine searches for ANALYZE. Last, so it is destroyed first: its
+    // searches are stopped and joined before anything they use goes away.
+    AnalysisPool analysis_;
 };
 
 #endif
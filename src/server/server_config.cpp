@@ -0,0 +1,70 @@
+#include "server_config.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+std::chrono::milliseconds seconds(double value) {
+    return std::chrono::milliseconds(static_cast<long long>(value * 1000));
+}
+
+} // namespace
+
+ServerConfig ServerConfig::fromArgs(int argc, char* argv[]) {
+    ServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string name = arg;
+        std::string value;
+
+        auto eq = arg.find('=');
+        if (eq != std::string::npos) {
+            name = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+        }
+
+        if (name == "--port")
+            config.port = static_cast<short>(std::atoi(value.c_str()));
+        else if (name == "--hash-mb")
+            config.hashMegabytes = std::strtoul(value.c_str(), nullptr, 10);
+        else if (name == "--io-threads")
+            config.ioThreads = std::max(0, std::atoi(value.c_str()));
+        else if (name == "--threads")
+            config.searchThreads = std::max(1, std::atoi(value.c_str()));
+        else if (name == "--clock") {
+            if (!parseTimeControl(value, config.timeControl))
+                std::cerr << "Ignoring bad time control: " << arg << std::endl;
+        }
+        else if (name == "--delay")
+            config.timeControl.delay = seconds(std::strtod(value.c_str(), nullptr));
+        else if (name == "--idle-timeout")
+            config.limits.idleTimeout = std::chrono::seconds(std::max(0, std::atoi(value.c_str())));
+        else if (name == "--max-connections")
+            config.limits.maxConnections = std::max(1, std::atoi(value.c_str()));
+        else if (name == "--accept-rate")
+            config.limits.acceptsPerSecond = std::max(0, std::atoi(value.c_str()));
+        else if (name == "--max-queued-kb")
+            config.limits.maxQueuedBytes = std::strtoul(value.c_str(), nullptr, 10) * 1024;
+        else if (name == "--analyses")
+            config.limits.analysisSearches = std::max(1, std::atoi(value.c_str()));
+        else if (name == "--analysis-queue")
+            config.limits.analysisQueue = std::strtoul(value.c_str(), nullptr, 10);
+        else if (name == "--wal")
+            config.logDirectory = value;
+        else if (name == "--book")
+            config.bookPath = value;
+        else if (name == "--wal-shards")
+            config.logShards = std::max(1, std::atoi(value.c_str()));
+        else if (name == "--huge-pages")
+            config.hugePages = true;
+        else
+            std::cerr << "Ignoring unknown option: " << arg << std::endl;
+    }
+
+    return config;
+}
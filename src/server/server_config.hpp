@@ -0,0 +1,48 @@
+#ifndef SERVER_CONFIG_HPP
+#define SERVER_CONFIG_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "game/chess_clock.hpp"
+#include "networking/connection_limits.hpp"
+
+/* ---------------- ServerConfig ---------------- */
+
+// Runtime settings, read from the command line: --name=value or --flag
+struct ServerConfig {
+    short port = 12345;
+
+    // Threads running the io_context; 0 = one per core
+    int ioThreads = 0;
+
+    // Shared transposition table (engine search + game status cache)
+    std::size_t hashMegabytes = 64;
+    bool hugePages = false;
+
+    // Threads per engine search (Lazy SMP); 1 searches single-threaded
+    int searchThreads = 1;
+
+    // Every game's time control: --clock=5+3 (minutes + seconds per
+    // move) and --delay=2 (seconds); untimed by default
+    TimeControl timeControl;
+
+    // --idle-timeout=600 (seconds, 0 = never), --max-connections=10000,
+    // --accept-rate=500 (per second), --max-queued-kb=256, --analyses=2
+    // (searches at once) and --analysis-queue=32
+    ConnectionLimits limits;
+
+    // Write-ahead move log: --wal=<directory> turns it on, and games in
+    // progress survive a restart; --wal-shards=4 files, each synced by its
+    // own thread
+    std::string logDirectory;
+    int logShards = 4;
+
+    // Opening book: --book=<file> (from book_build) answers ANALYZE in
+    // book positions without a search
+    std::string bookPath;
+
+    static ServerConfig fromArgs(int argc, char* argv[]);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "chess/pgn.hpp"
+#include "engine/opening_book.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Usage: book_bench <book.bin> [games.pgn] [rounds]
+ *
+ * Opening book speed and reach. The games (the sample games in data/ by
+ * default) are replayed up to ply 20, and every position on the way is
+ * kept. Each round looks all of them up in the book.
+ *
+ * Reports microseconds per lookup and lookups per second, then for each
+ * ply the share of games still in the book there: every move so far was
+ * a book hit, so the server would not have searched yet.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPlies = 20;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: book_bench <book.bin> [games.pgn] [rounds]\n";
+        return 1;
+    }
+    std::string gamesPath = argc > 2 ? argv[2] : "data/sample.pgn";
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 20;
+    if (rounds < 1) {
+        std::cerr << "Usage: book_bench <book.bin> [games.pgn] [rounds]\n";
+        return 1;
+    }
+
+    std::vector<ChessBoard> positions;
+    std::vector<int> inBook(kPlies + 1, 0); // games whose first n plies were all book hits
+    std::size_t games = 0, hits = 0;
+    double seconds = 0;
+
+    try {
+        OpeningBook book(argv[1]);
+
+        PgnReader reader(gamesPath);
+        PgnGame game;
+        ChessBoard board;
+        OpeningBook::Moves moves;
+        while (reader.next(game)) {
+            if (!game.tag("FEN").empty())
+                continue;
+            ++games;
+            board.initialize();
+
+            bool stillIn = true;
+            PgnMoves sans(game.movetext);
+            std::string_view san;
+            for (int ply = 1; ply <= kPlies && sans.next(san); ++ply) {
+                Move move = board.fromSAN(san);
+                if (move.isNull())
+                    break;
+                positions.push_back(board);
+                stillIn = stillIn && book.lookup(board, moves) > 0;
+                if (stillIn)
+                    ++inBook[ply];
+                board.playMove(move);
+            }
+        }
+
+        auto start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            hits = 0;
+            for (const ChessBoard& position : positions)
+                hits += book.lookup(position, moves) > 0;
+        }
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "book " << argv[1] << "  entries " << book.entries() << "\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "book_bench: " << e.what() << "\n";
+        return 1;
+    }
+
+    double lookups = static_cast<double>(positions.size()) * rounds;
+    std::cout << "positions " << positions.size() << "  hits " << hits << "  "
+              << seconds / lookups * 1e6 << " us/lookup  "
+              << static_cast<std::uint64_t>(lookups / seconds) << " lookups/s\n"
+              << "games in book by ply (of " << games << "):\n";
+    for (int ply = 1; ply <= kPlies; ++ply)
+        std::cout << "  " << ply << "  " << 100.0 * inBook[ply] / std::max<std::size_t>(games, 1)
+                  << "%\n";
+    return 0;
+}
@@ -0,0 +1,306 @@
+#include "chess/pgn.hpp"
+#include "game/move_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Usage: chess_validate [--threads=N] [--quiet] <games.pgn | move-log-directory>
+ *
+ * Checks an archive of games against the server's own rules. Each game
+ * is replayed on a ChessBoard, and every move must parse and be legal.
+ * Its result must agree with how it ended:
+ *   - a game that ends in checkmate is won by the side that gave mate
+ *   - a stalemate is a draw
+ *   - the Result tag and the result after the moves agree
+ * Decisive results and draws in open positions (resignation, time,
+ * agreement) cannot be checked, and are counted as they are.
+ *
+ * A directory is read as a move log (see --wal on the server): its
+ * unfinished games are replayed, and each move must be legal.
+ *
+ * A PGN file is mapped once and cut into pieces of whole games, many
+ * more pieces than threads. Thread i takes pieces i, i + N, i + 2N, and
+ * so on. Each thread has its own board and counters and hands them back
+ * when it is done, so threads share nothing while they run.
+ *
+ * Prints one line per problem (unless --quiet), then a summary. Exits
+ * with 0 if every game checks out, 1 if not, and 2 if the archive could
+ * not be read.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Pieces per thread: enough that one slow piece does not hold up the end
+constexpr std::size_t kPiecesPerThread = 16;
+
+struct Problem {
+    // Where the game is: its first line within the piece, or the game ID
+    // for a move log
+    std::size_t piece = 0;
+    std::size_t line = 0;
+    std::string what;
+};
+
+// What one thread found. Filled in locally and handed back once.
+struct Findings {
+    std::uint64_t games = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t whiteWins = 0, blackWins = 0, draws = 0, unfinished = 0;
+    std::uint64_t checkmates = 0, stalemates = 0;
+    std::uint64_t illegal = 0, badResults = 0;
+    std::vector<Problem> problems;
+    std::vector<std::pair<std::size_t, std::size_t>> pieceLines; // piece, lines in it
+
+    void add(const Findings& other) {
+        games += other.games;
+        moves += other.moves;
+        whiteWins += other.whiteWins;
+        blackWins += other.blackWins;
+        draws += other.draws;
+        unfinished += other.unfinished;
+        checkmates += other.checkmates;
+        stalemates += other.stalemates;
+        illegal += other.illegal;
+        badResults += other.badResults;
+        problems.insert(problems.end(), other.problems.begin(), other.problems.end());
+        pieceLines.insert(pieceLines.end(), other.pieceLines.begin(), other.pieceLines.end());
+    }
+};
+
+std::string quoted(std::string_view text) {
+    return "\"" + std::string(text) + "\"";
+}
+
+// "Morphy, Paul - Duke Karl, round 3" for reports
+std::string describe(const PgnGame& game) {
+    std::string text = std::string(game.tag("White")) + " - " + std::string(game.tag("Black"));
+    if (std::string_view round = game.tag("Round"); !round.empty() && round != "?")
+        text += ", round " + std::string(round);
+    return text;
+}
+
+// Checks one game; an empty string if it is fine
+std::string checkGame(const PgnGame& game, ChessBoard& board, Findings& found) {
+    PgnReplay replay = replayGame(game, board);
+    found.moves += static_cast<std::uint64_t>(replay.plies);
+
+    if (!replay.ok()) {
+        ++found.illegal;
+        if (replay.failed.data() == game.tag("FEN").data())
+            return "bad FEN " + quoted(replay.failed);
+        return "illegal move " + quoted(replay.failed) + " at ply " +
+               std::to_string(replay.plies + 1);
+    }
+
+    std::string_view result = replay.result;
+    if (result == "1-0")
+        ++found.whiteWins;
+    else if (result == "0-1")
+        ++found.blackWins;
+    else if (result == "1/2-1/2")
+        ++found.draws;
+    else
+        ++found.unfinished;
+
+    std::string problem;
+    GameStatus status = board.status();
+    if (status == GameStatus::Checkmate) {
+        ++found.checkmates;
+        std::string_view won = board.sideToMove() == Color::White ? "0-1" : "1-0";
+        if (result != won)
+            problem = "checkmate, but the result is " + quoted(result) + " not " + quoted(won);
+    }
+    else if (status == GameStatus::Stalemate) {
+        ++found.stalemates;
+        if (result != "1/2-1/2")
+            problem = "stalemate, but the result is " + quoted(result);
+    }
+
+    std::string_view tag = game.tag("Result");
+    if (problem.empty() && result.empty())
+        problem = "no result after the moves";
+    else if (problem.empty() && !tag.empty() && tag != result)
+        problem = "Result tag " + quoted(tag) + " but the moves end with " + quoted(result);
+
+    if (!problem.empty())
+        ++found.badResults;
+    return problem;
+}
+
+// Thread `index` of `threads` goes through its share of the pieces
+Findings checkPieces(const std::vector<std::string_view>& pieces,
+                     std::size_t index, std::size_t threads) {
+    Findings found;
+    ChessBoard board;
+    PgnGame game;
+
+    for (std::size_t piece = index; piece < pieces.size(); piece += threads) {
+        std::string_view text = pieces[piece];
+        PgnReader reader(text);
+
+        // Lines are counted only as far as the last problem, then to the end
+        const char* counted = text.data();
+        std::size_t lines = 0;
+
+        while (reader.next(game)) {
+            ++found.games;
+            std::string problem = checkGame(game, board, found);
+            if (problem.empty())
+                continue;
+
+            lines += static_cast<std::size_t>(std::count(counted, game.text.data(), '\n'));
+            counted = game.text.data();
+            found.problems.push_back({ piece, lines, describe(game) + ": " + problem });
+        }
+
+        lines += static_cast<std::size_t>(std::count(counted, text.data() + text.size(), '\n'));
+        found.pieceLines.emplace_back(piece, lines);
+    }
+    return found;
+}
+
+// Runs `work(index, threads)` on every thread and adds up what they found
+template <typename Work>
+Findings onThreads(std::size_t threads, Work work) {
+    std::vector<Findings> results(threads);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back([&, i] { results[i] = work(i, threads); });
+    for (std::thread& worker : workers)
+        worker.join();
+
+    Findings total;
+    for (const Findings& result : results)
+        total.add(result);
+    return total;
+}
+
+Findings checkPgn(const std::string& path, std::size_t threads, std::size_t& bytes) {
+    PgnReader file(path);
+    bytes = file.size();
+    std::vector<std::string_view> pieces = splitGames(file.text(), threads * kPiecesPerThread);
+
+    Findings found = onThreads(threads, [&](std::size_t index, std::size_t count) {
+        return checkPieces(pieces, index, count);
+    });
+
+    // Problem lines were counted within their piece; add the lines before it
+    std::vector<std::size_t> firstLine(pieces.size() + 1, 1);
+    std::sort(found.pieceLines.begin(), found.pieceLines.end());
+    for (const auto& [piece, lines] : found.pieceLines)
+        firstLine[piece + 1] = firstLine[piece] + lines;
+    for (Problem& problem : found.problems)
+        problem.line += firstLine[problem.piece];
+    return found;
+}
+
+Findings checkMoveLog(const std::string& directory, std::size_t threads) {
+    std::vector<LoggedGame> games = MoveLog::recover(directory);
+
+    return onThreads(threads, [&](std::size_t index, std::size_t count) {
+        Findings found;
+        ChessBoard board;
+        MoveList legal;
+
+        for (std::size_t i = index; i < games.size(); i += count) {
+            const LoggedGame& game = games[i];
+            ++found.games;
+            ++found.unfinished;
+            board.initialize();
+
+            for (std::size_t ply = 0; ply < game.moves.size(); ++ply) {
+                Move move = game.moves[ply];
+                board.generateLegalMoves(legal);
+                if (std::find(legal.begin(), legal.end(), move) == legal.end()) {
+                    ++found.illegal;
+                    found.problems.push_back({ 0, game.id,
+                        "illegal move " + move.toString() + " at ply " + std::to_string(ply + 1) });
+                    break;
+                }
+                board.playMove(move);
+                ++found.moves;
+            }
+        }
+        return found;
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* usage =
+        "Usage: chess_validate [--threads=N] [--quiet] <games.pgn | move-log-directory>\n";
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool quiet = false;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0 && std::atoi(argv[i] + 10) > 0)
+            threads = static_cast<std::size_t>(std::atoi(argv[i] + 10));
+        else if (std::strcmp(argv[i], "--quiet") == 0)
+            quiet = true;
+        else if (argv[i][0] != '-' && path.empty())
+            path = argv[i];
+        else {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << usage;
+        return 2;
+    }
+
+    bool moveLog = std::filesystem::is_directory(path);
+    std::size_t bytes = 0;
+    Findings found;
+    auto start = Clock::now();
+
+    try {
+        found = moveLog ? checkMoveLog(path, threads) : checkPgn(path, threads, bytes);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "chess_validate: " << e.what() << "\n";
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(found.problems.begin(), found.problems.end(),
+              [](const Problem& a, const Problem& b) { return a.line < b.line; });
+    if (!quiet) {
+        for (const Problem& problem : found.problems)
+            std::cout << (moveLog ? "game " : "line ") << problem.line << ": "
+                      << problem.what << "\n";
+    }
+
+    std::cout << "games " << found.games << "  moves " << found.moves
+              << "  threads " << threads << "  " << seconds << " s  "
+              << static_cast<std::uint64_t>(found.games / seconds) << " games/s";
+    if (!moveLog)
+        std::cout << "  " << bytes / 1e6 / seconds << " MB/s";
+    std::cout << "\n";
+
+    if (moveLog) {
+        std::cout << "in progress " << found.unfinished << "\n";
+    }
+    else {
+        std::cout << "results  1-0 " << found.whiteWins << "  0-1 " << found.blackWins
+                  << "  1/2-1/2 " << found.draws << "  other " << found.unfinished << "\n"
+                  << "endings  checkmate " << found.checkmates
+                  << "  stalemate " << found.stalemates << "\n";
+    }
+    std::cout << "problems " << found.problems.size() << "  (illegal moves "
+              << found.illegal << ", results " << found.badResults << ")\n";
+
+    return found.problems.empty() ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include "chess/chess_board.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Usage: fen_bench [positions] [rounds]
+ *
+ * FEN parsing and writing speed. Positions come from random legal games,
+ * one FEN per line in one buffer, the way a batch file arrives. Every
+ * round parses the whole buffer with fromFEN() and writes every position
+ * back with toFEN(); the first round also checks that each one comes back
+ * with the same key and the same text.
+ *
+ * Reports megabytes and positions per second for each direction.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (count < 1 || rounds < 1) {
+        std::cerr << "Usage: fen_bench [positions] [rounds]\n";
+        return 1;
+    }
+
+    // Positions from random games, 1 to 80 plies in
+    std::mt19937_64 random(12345);
+    std::string text;
+    std::vector<std::uint64_t> keys;
+    ChessBoard board;
+    char fen[ChessBoard::kMaxFEN];
+
+    while (static_cast<int>(keys.size()) < count) {
+        board.initialize();
+        int plies = 1 + static_cast<int>(random() % 80);
+        MoveList moves;
+        for (int i = 0; i < plies; ++i) {
+            moves.clear();
+            board.generateLegalMoves(moves);
+            if (moves.empty())
+                break;
+            board.playMove(moves[random() % moves.size()]);
+        }
+        text.append(fen, board.toFEN(fen));
+        text += '\n';
+        keys.push_back(board.hash());
+    }
+
+    double parseSeconds = 0, writeSeconds = 0;
+    std::size_t written = 0;
+
+    for (int round = 0; round < rounds; ++round) {
+        // Parse: one line at a time, straight out of the buffer
+        auto start = Clock::now();
+        std::size_t at = 0;
+        for (int i = 0; i < count; ++i) {
+            std::size_t end = text.find('\n', at);
+            if (!board.fromFEN(std::string_view(text).substr(at, end - at))) {
+                std::cerr << "Did not parse: " << text.substr(at, end - at) << "\n";
+                return 1;
+            }
+            if (round == 0 && board.hash() != keys[i]) {
+                std::cerr << "Wrong key for: " << text.substr(at, end - at) << "\n";
+                return 1;
+            }
+            at = end + 1;
+        }
+        double parsed = secondsSince(start);
+        parseSeconds += parsed;
+
+        // Write: parse each position again and write it back; the parse
+        // time just measured is taken off
+        start = Clock::now();
+        at = 0;
+        written = 0;
+        for (int i = 0; i < count; ++i) {
+            std::size_t end = text.find('\n', at);
+            std::string_view line = std::string_view(text).substr(at, end - at);
+            board.fromFEN(line);
+            std::size_t length = board.toFEN(fen);
+
+            if (round == 0 && std::string_view(fen, length) != line) {
+                std::cerr << "Wrote " << fen << " for " << line << "\n";
+                return 1;
+            }
+            written += length + 1;
+            at = end + 1;
+        }
+        writeSeconds += secondsSince(start) - parsed;
+    }
+
+    double megabytes = static_cast<double>(text.size()) * rounds / 1e6;
+    std::cout << "positions " << count << "  bytes " << text.size()
+              << "  average " << text.size() / count << " bytes\n"
+              << "fromFEN  " << megabytes / parseSeconds << " MB/s  "
+              << static_cast<std::uint64_t>(count * rounds / parseSeconds) << " positions/s\n"
+              << "toFEN    " << static_cast<double>(written) * rounds / 1e6 / writeSeconds
+              << " MB/s  "
+              << static_cast<std::uint64_t>(count * rounds / writeSeconds) << " positions/s\n";
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Usage: load_test [games] [moves-per-game] [threads] [host] [port]
+ *
+ * Opens 2 * games connections to a running chess_server, lets the server
+ * pair them, and has every game shuffle its knights back and forth
+ * (G1-F3 / G8-F6 and back) for the given number of moves. Each side only
+ * moves after seeing the server confirm the previous move, so the result
+ * measures full round trips: moves per second across all games.
+ */
+using boost::asio::ip::tcp;
+
+namespace {
+
+std::atomic<std::uint64_t> totalMoves{ 0 };
+std::atomic<int> finishedGames{ 0 };
+
+const char* const kWhiteMoves[] = { "MOVE G1 F3\n", "MOVE F3 G1\n" };
+const char* const kBlackMoves[] = { "MOVE G8 F6\n", "MOVE F6 G8\n" };
+
+class LoadClient : public std::enable_shared_from_this<LoadClient> {
+public:
+    LoadClient(boost::asio::io_context& io, int movesPerGame)
+        : socket_(io), movesPerGame_(movesPerGame) {}
+
+    void start(const tcp::resolver::results_type& endpoints) {
+        boost::asio::connect(socket_, endpoints);
+        read();
+    }
+
+private:
+    void read() {
+        auto self = shared_from_this();
+        socket_.async_read_some(boost::asio::buffer(buffer_),
+            [this, self](const boost::system::error_code& ec, std::size_t n) {
+                if (ec)
+                    return;
+                pending_.append(buffer_, n);
+                process();
+                if (ply_ < movesPerGame_)
+                    read();
+            });
+    }
+
+    // Handles every complete marker in what has arrived so far
+    void process() {
+        static const std::string markers[] = {
+            "You are White", "You are Black", "Game started!", "MOVED "
+        };
+
+        for (;;) {
+            std::size_t best = std::string::npos;
+            int which = -1;
+            for (int i = 0; i < 4; ++i) {
+                std::size_t at = pending_.find(markers[i]);
+                if (at < best) {
+                    best = at;
+                    which = i;
+                }
+            }
+
+            if (which < 0) {
+                // Keep a tail in case a marker was split between reads
+                if (pending_.size() > 32)
+                    pending_.erase(0, pending_.size() - 32);
+                return;
+            }
+            pending_.erase(0, best + markers[which].size());
+
+            switch (which) {
+                case 0: white_ = true; break;
+                case 1: white_ = false; break;
+                case 2: started_ = true; moveIfOurTurn(); break;
+                case 3:
+                    ++ply_;
+                    if (white_)
+                        totalMoves.fetch_add(1, std::memory_order_relaxed);
+                    if (ply_ == movesPerGame_ && white_)
+                        ++finishedGames;
+                    moveIfOurTurn();
+                    break;
+            }
+        }
+    }
+
+    void moveIfOurTurn() {
+        if (!started_ || ply_ >= movesPerGame_)
+            return;
+        if ((ply_ % 2 == 0) != white_)
+            return;
+
+        int own = ply_ / 2;
+        const char* move = white_ ? kWhiteMoves[own % 2] : kBlackMoves[own % 2];
+        boost::asio::write(socket_, boost::asio::buffer(move, std::strlen(move)));
+    }
+
+    tcp::socket socket_;
+    char buffer_[4096];
+    std::string pending_;
+
+    int movesPerGame_;
+    int ply_ = 0;
+    bool white_ = false;
+    bool started_ = false;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 100;
+    int moves = argc > 2 ? std::atoi(argv[2]) : 200;
+    int threads = argc > 3
+        ? std::atoi(argv[3])
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string host = argc > 4 ? argv[4] : "127.0.0.1";
+    std::string port = argc > 5 ? argv[5] : "12345";
+
+    if (games < 1 || moves < 1 || threads < 1) {
+        std::cerr << "Usage: load_test [games] [moves-per-game] [threads] [host] [port]\n";
+        return 1;
+    }
+
+    boost::asio::io_context io(threads);
+    tcp::resolver resolver(io);
+    auto endpoints = resolver.resolve(host, port);
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    // Everyone seeks at the default rating; the matchmaker pairs them
+    std::vector<std::shared_ptr<LoadClient>> clients;
+    for (int i = 0; i < 2 * games; ++i) {
+        clients.push_back(std::make_shared<LoadClient>(io, moves));
+        clients.back()->start(endpoints);
+    }
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+        pool.emplace_back([&io] { io.run(); });
+    for (std::thread& thread : pool)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::uint64_t played = totalMoves.load();
+
+    std::cout << "games " << games
+              << "  finished " << finishedGames.load()
+              << "  moves " << played
+              << "  time " << seconds << "s"
+              << "  moves/s " << static_cast<std::uint64_t>(
+                     seconds > 0 ? played / seconds : 0)
+              << "\n";
+
+    return finishedGames.load() == games ? 0 : 1;
+}
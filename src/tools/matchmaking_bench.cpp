@@ -0,0 +1,98 @@
+#include "game/matchmaker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+ * Usage: matchmaking_bench [arrivals-per-second] [seconds] [time-controls]
+ *
+ * Synthetic load for the matchmaker, with no network in the way. Players
+ * arrive at random (Poisson) at the given rate for the given simulated
+ * time, with ratings spread around 1500 and one of the first
+ * time-controls of a fixed list, and the pool is paired on the server's
+ * 50 ms tick. Simulated time runs as fast as the matchmaker allows.
+ *
+ * Reports the pairing throughput (matches per second of real CPU time)
+ * and the wait percentiles players would have seen.
+ */
+namespace {
+
+constexpr std::chrono::milliseconds kTick{ 50 };
+
+const TimeControl kTimeControls[] = {
+    { std::chrono::minutes(1),  std::chrono::seconds(0),  {} },
+    { std::chrono::minutes(3),  std::chrono::seconds(2),  {} },
+    { std::chrono::minutes(5),  std::chrono::seconds(3),  {} },
+    { std::chrono::minutes(10), std::chrono::seconds(0),  {} },
+    { std::chrono::minutes(15), std::chrono::seconds(10), {} },
+};
+constexpr int kTimeControlCount = sizeof(kTimeControls) / sizeof(kTimeControls[0]);
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double rate = argc > 1 ? std::atof(argv[1]) : 2000;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 60;
+    int controls = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    if (rate <= 0 || seconds < 1 || controls < 1 || controls > kTimeControlCount) {
+        std::cerr << "Usage: matchmaking_bench [arrivals-per-second] [seconds] "
+                     "[time-controls 1-" << kTimeControlCount << "]\n";
+        return 1;
+    }
+
+    std::mt19937_64 random(12345);
+    std::exponential_distribution<double> gap(rate);
+    std::normal_distribution<double> rating(1500, 350);
+    std::uniform_int_distribution<int> control(0, controls - 1);
+
+    using Clock = Matchmaker::Clock;
+    Matchmaker matchmaker;
+    std::vector<Match> matches;
+
+    Clock::time_point start = Clock::now();   // simulated time starts here
+    Clock::duration end = std::chrono::seconds(seconds);
+    Clock::duration nextArrival{ 0 };
+    std::uint64_t arrivals = 0;
+
+    auto cpuStart = Clock::now();
+
+    for (Clock::duration now{ 0 }; now <= end; now += kTick) {
+        // Everyone who shows up before this tick
+        while (nextArrival <= now) {
+            Seeker seeker;
+            seeker.rating = std::clamp(static_cast<int>(rating(random)), 400, 3000);
+            seeker.timeControl = kTimeControls[control(random)];
+            seeker.since = start + nextArrival;
+            matchmaker.enqueue(std::move(seeker));
+            ++arrivals;
+
+            nextArrival += std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(gap(random)));
+        }
+
+        matchmaker.tick(start + now, matches);
+        matches.clear();
+    }
+
+    double cpu = std::chrono::duration<double>(Clock::now() - cpuStart).count();
+    Matchmaker::Stats stats = matchmaker.stats();
+
+    std::cout << "arrivals " << arrivals
+              << "  matches " << stats.matches
+              << "  waiting " << stats.waiting
+              << "  time " << cpu << "s"
+              << "  matches/s " << static_cast<std::uint64_t>(
+                     cpu > 0 ? stats.matches / cpu : 0)
+              << "\n"
+              << "wait (last " << std::min<std::uint64_t>(2 * stats.matches, 4096)
+              << " players)  p50 " << stats.p50.count() << "ms"
+              << "  p90 " << stats.p90.count() << "ms"
+              << "  p99 " << stats.p99.count() << "ms"
+              << "  max " << stats.max.count() << "ms\n";
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "chess/chess_board.hpp"
+#include "chess/perft.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/*
+ * Usage: perft <depth> [--divide] [--fen "<fen>"]
+ *
+ * Counts legal leaf nodes from the starting position (or the FEN given)
+ * for every depth up to <depth> and reports nodes per second. --divide
+ * prints the node count below each root move at the final depth (useful
+ * to bisect a bug).
+ */
+int main(int argc, char* argv[]) {
+    const char* usage = "Usage: perft <depth> [--divide] [--fen \"<fen>\"]\n";
+    if (argc < 2) {
+        std::cerr << usage;
+        return 1;
+    }
+
+    int maxDepth = std::atoi(argv[1]);
+    bool divide = false;
+    const char* fen = nullptr;
+
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--divide") == 0)
+            divide = true;
+        else if (std::strcmp(argv[i], "--fen") == 0 && i + 1 < argc)
+            fen = argv[++i];
+        else {
+            std::cerr << usage;
+            return 1;
+        }
+    }
+
+    ChessBoard board;
+    board.initialize();
+    if (fen && !board.fromFEN(fen)) {
+        std::cerr << "Not a valid FEN: " << fen << "\n";
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        auto start = Clock::now();
+        std::uint64_t nodes = perft(board, depth);
+        double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "depth " << depth
+                  << "  nodes " << nodes
+                  << "  time " << seconds << "s"
+                  << "  nps " << static_cast<std::uint64_t>(
+                         seconds > 0 ? nodes / seconds : 0)
+                  << "\n";
+    }
+
+    if (divide) {
+        MoveList moves;
+        board.generateLegalMoves(moves);
+
+        std::cout << "\n";
+        for (Move move : moves) {
+            board.makeMove(move);
+            std::cout << move.toString() << ": "
+                      << perft(board, maxDepth - 1) << "\n";
+            board.unmakeMove();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "chess/pgn.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+/*
+ * Usage: pgn_bench [file.pgn] [rounds]
+ *
+ * PGN reading speed, on the sample games in data/ unless a file is given.
+ * Each round maps the file and reads it twice: once splitting it into
+ * games and tokenizing tags and moves only, then again replaying every
+ * move on a ChessBoard, with each SAN move matched against the legal moves.
+ *
+ * Reports games and megabytes per second for both, and moves per second
+ * for the replay. Games that do not replay are counted, and the first
+ * one is shown.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "data/sample.pgn";
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (rounds < 1) {
+        std::cerr << "Usage: pgn_bench [file.pgn] [rounds]\n";
+        return 1;
+    }
+
+    double scanSeconds = 0, replaySeconds = 0;
+    std::size_t bytes = 0, games = 0, tokens = 0, plies = 0, failed = 0;
+    PgnGame game;
+    ChessBoard board;
+
+    try {
+        for (int round = 0; round < rounds; ++round) {
+            // Tokenize only
+            auto start = Clock::now();
+            PgnReader scan(path);
+            bytes = scan.size();
+            games = tokens = 0;
+            while (scan.next(game)) {
+                ++games;
+                PgnMoves moves(game.movetext);
+                std::string_view san;
+                while (moves.next(san))
+                    ++tokens;
+            }
+            scanSeconds += secondsSince(start);
+
+            // Tokenize and replay
+            start = Clock::now();
+            PgnReader replay(path);
+            plies = failed = 0;
+            while (replay.next(game)) {
+                PgnReplay played = replayGame(game, board);
+                plies += static_cast<std::size_t>(played.plies);
+                if (played.ok())
+                    continue;
+                if (failed++ == 0 && round == 0)
+                    std::cerr << "Could not play \"" << played.failed << "\" in:\n"
+                              << game.text << "\n\n";
+            }
+            replaySeconds += secondsSince(start);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "pgn_bench: " << e.what() << "\n";
+        return 1;
+    }
+
+    double megabytes = static_cast<double>(bytes) * rounds / 1e6;
+    double played = static_cast<double>(games) * rounds;
+    std::cout << "games " << games << "  moves " << tokens << "  bytes " << bytes
+              << "  failed " << failed << "\n"
+              << "scan    " << megabytes / scanSeconds << " MB/s  "
+              << static_cast<std::uint64_t>(played / scanSeconds) << " games/s\n"
+              << "replay  " << megabytes / replaySeconds << " MB/s  "
+              << static_cast<std::uint64_t>(played / replaySeconds) << " games/s  "
+              << static_cast<std::uint64_t>(static_cast<double>(plies) * rounds / replaySeconds)
+              << " moves/s\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "game/game_registry.hpp"
+#include "game/move_log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Player {};
+
+/*
+ * Usage: recovery_bench [games] [moves-per-game] [shards] [directory]
+ *
+ * Writes a move log the way a busy server would, then recovers it the way
+ * a restarted one does.
+ *
+ * Each game is a random legal game of up to the given number of moves.
+ * Four threads log them, one move of each game in turn, so many games are
+ * in progress at once, like on a busy server. That part reports moves
+ * per second once they are all on disk, and how many moves each sync
+ * carried. Recovery then reads the log back and replays every game
+ * through the board, on every core, which is what the server does before
+ * it starts accepting.
+ *
+ * The log goes to a scratch directory that is removed at the end, unless
+ * one is given.
+ */
+namespace {
+
+constexpr int kWriters = 4;
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// A random game: legal moves until it ends or reaches `length`
+std::vector<Move> randomGame(std::mt19937_64& random, int length) {
+    ChessBoard board;
+    board.initialize();
+
+    std::vector<Move> moves;
+    MoveList legal;
+    for (int i = 0; i < length; ++i) {
+        legal.clear();
+        board.generateLegalMoves(legal);
+        if (legal.empty())
+            break;
+        Move move = legal[random() % legal.size()];
+        board.playMove(move);
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int length = argc > 2 ? std::atoi(argv[2]) : 40;
+    int shards = argc > 3 ? std::atoi(argv[3]) : 4;
+    bool scratch = argc <= 4;
+    std::filesystem::path dir = scratch
+        ? std::filesystem::temp_directory_path() / "chessy-recovery-bench"
+        : std::filesystem::path(argv[4]);
+
+    if (games < 1 || length < 1 || shards < 1) {
+        std::cerr << "Usage: recovery_bench [games] [moves-per-game] [shards] [directory]\n";
+        return 1;
+    }
+    std::filesystem::remove_all(dir);
+
+    std::cout << "Playing " << games << " random games..." << std::endl;
+    std::mt19937_64 random(12345);
+    std::vector<std::vector<Move>> played(games);
+    std::uint64_t total = 0;
+    for (auto& moves : played) {
+        moves = randomGame(random, length);
+        total += moves.size();
+    }
+
+    /* ---- Logging ---- */
+    TimeControl control{ std::chrono::minutes(5), std::chrono::seconds(3), {} };
+    std::atomic<std::uint64_t> durable{ 0 };
+    MoveLog::Stats stats;
+    double writeSeconds = 0;
+    {
+        MoveLog log(dir.string(), shards);
+        auto start = Clock::now();
+
+        std::vector<std::thread> writers;
+        for (int w = 0; w < kWriters; ++w) {
+            writers.emplace_back([&, w] {
+                for (int g = w; g < games; g += kWriters)
+                    log.logStart(g + 1, control, g + 1, ~std::uint64_t(g + 1));
+
+                for (int ply = 0; ply < length; ++ply)
+                    for (int g = w; g < games; g += kWriters)
+                        if (ply < static_cast<int>(played[g].size()))
+                            log.logMove(g + 1, played[g][ply], control.base,
+                                        [&durable] { ++durable; });
+            });
+        }
+        for (std::thread& writer : writers)
+            writer.join();
+
+        while (durable.load() < total)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        writeSeconds = secondsSince(start);
+        stats = log.stats();
+    }
+
+    std::cout << "logged " << total << " moves in " << writeSeconds << "s"
+              << "  moves/s " << static_cast<std::uint64_t>(total / writeSeconds)
+              << "  syncs " << stats.syncs
+              << "  moves/sync " << (stats.syncs ? total / stats.syncs : 0)
+              << "  " << stats.bytes / 1024 << " KiB\n";
+
+    /* ---- Recovery ---- */
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    TranspositionTable table(16);
+    boost::asio::io_context io;
+    GameRegistry registry(table, io);
+
+    auto start = Clock::now();
+    std::vector<LoggedGame> logged = MoveLog::recover(dir.string());
+    double readSeconds = secondsSince(start);
+    std::vector<std::shared_ptr<Game>> restored = registry.restore(logged, threads);
+    double recoverSeconds = secondsSince(start);
+
+    auto failed = std::count(restored.begin(), restored.end(), nullptr);
+    std::cout << "recovered " << registry.size() << " games in " << recoverSeconds << "s"
+              << " (read " << readSeconds << "s, replay on " << threads << " threads)"
+              << "  failed " << failed << "\n";
+
+    if (scratch)
+        std::filesystem::remove_all(dir);
+    return failed == 0 && registry.size() == static_cast<std::size_t>(games) ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include "chess/chess_board.hpp"
+#include "engine/parallel_search.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Usage: search_bench [depth] [max-threads] [hash-mb]
+ *
+ * Searches a fixed set of positions to a fixed depth with 1, 2, 4, ...
+ * threads up to max-threads (default: every core) and reports the time to
+ * depth, its speedup over one thread and the share of table probes that
+ * hit. The table is cleared before every position so each run starts
+ * cold; only the searches are timed, not the clearing.
+ */
+namespace {
+
+// Openings and middlegames, as moves from the starting position
+const char* const kPositions[] = {
+    "",
+    "e2e4 e7e5 g1f3 b8c6 f1c4 f8c5 c2c3 g8f6 d2d4 e5d4 c3d4 c5b4",
+    "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6 c1g5 f8e7 e2e3 e8g8 g1f3 b8d7",
+    "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6 c1e3 e7e5 d4b3 c8e6",
+    "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7 f1e1 b7b5 a4b3 d7d6 c2c3 e8g8",
+    "d2d4 g8f6 c2c4 g7g6 b1c3 f8g7 e2e4 d7d6 g1f3 e8g8 f1e2 e7e5",
+};
+
+// Plays space-separated moves in coordinate notation; false on an illegal one
+bool playMoves(ChessBoard& board, const std::string& line) {
+    std::istringstream in(line);
+    std::string text;
+
+    while (in >> text) {
+        MoveList moves;
+        board.generateLegalMoves(moves);
+        auto it = std::find_if(moves.begin(), moves.end(),
+            [&](Move move) { return move.toString() == text; });
+        if (it == moves.end())
+            return false;
+        board.makeMove(*it);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int depth = argc > 1 ? std::atoi(argv[1]) : 8;
+    int maxThreads = argc > 2
+        ? std::atoi(argv[2])
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::size_t hashMegabytes = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256;
+
+    if (depth < 1 || maxThreads < 1) {
+        std::cerr << "Usage: search_bench [depth] [max-threads] [hash-mb]\n";
+        return 1;
+    }
+
+    std::vector<ChessBoard> positions;
+    for (const char* line : kPositions) {
+        ChessBoard board;
+        board.initialize();
+        if (!playMoves(board, line)) {
+            std::cerr << "Illegal move in bench position: " << line << "\n";
+            return 1;
+        }
+        positions.push_back(board);
+    }
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    TranspositionTable table(hashMegabytes);
+
+    SearchLimits limits;
+    limits.maxDepth = depth;
+
+    using Clock = std::chrono::steady_clock;
+    double baseline = 0;
+
+    std::cout << positions.size() << " positions, depth " << depth
+              << ", hash " << hashMegabytes << " MB\n\n";
+
+    for (int threads : threadCounts) {
+        ParallelSearch search(table, threads);
+        std::uint64_t nodes = 0, hits = 0, probes = 0;
+        double seconds = 0;
+
+        for (const ChessBoard& board : positions) {
+            // One thread wipes the table, whatever the count; leave it out
+            table.clear();
+            auto start = Clock::now();
+            SearchResult result = search.run(board, limits);
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+            nodes += result.nodes;
+            hits += result.tableHits;
+            probes += result.tableHits + result.tableMisses;
+        }
+
+        if (threads == 1)
+            baseline = seconds;
+
+        std::cout << "threads " << std::setw(3) << threads
+                  << "  time " << std::fixed << std::setprecision(3)
+                  << seconds << "s"
+                  << "  nodes " << nodes
+                  << "  nps " << static_cast<std::uint64_t>(
+                         seconds > 0 ? nodes / seconds : 0)
+                  << "  speedup " << std::setprecision(2)
+                  << (seconds > 0 ? baseline / seconds : 0) << "x"
+                  << "  tt hits " << std::setprecision(1)
+                  << (probes > 0 ? 100.0 * hits / probes : 0) << "%\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "engine/analysis_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Analysis pool runs every search it takes and reports it") {
+    TranspositionTable table(4);
+    ChessBoard board;
+    board.initialize();
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    int reported = 0;
+    bool allFound = true;
+
+    AnalysisPool pool(table, 2, 1, 8);
+    REQUIRE(pool.workers() == 2);
+    for (int i = 0; i < 6; ++i) {
+        REQUIRE(pool.submit(board, limits, [&](const SearchResult& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            allFound = allFound && !result.bestMove.isNull();
+            ++reported;
+            done.notify_one();
+        }));
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    REQUIRE(done.wait_for(lock, 30s, [&] { return reported == 6; }));
+    REQUIRE(allFound);
+}
+
+TEST_CASE("Analysis pool turns requests away when full, and stops on destruction") {
+    TranspositionTable table(4);
+    ChessBoard board;
+    board.initialize();
+
+    // Far longer than the test is willing to wait
+    SearchLimits forever;
+    forever.time = 60s;
+
+    std::atomic<int> reported{ 0 };
+    auto count = [&](const SearchResult&) { ++reported; };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        AnalysisPool pool(table, 1, 1, 1);
+        REQUIRE(pool.submit(board, forever, count));
+
+        // The worker takes the first; one more fits in the queue
+        while (pool.queued() > 0)
+            std::this_thread::sleep_for(1ms);
+        REQUIRE(pool.submit(board, forever, count));
+        REQUIRE_FALSE(pool.submit(board, forever, count));
+        REQUIRE(pool.queued() == 1);
+    }
+
+    // The running search was stopped and joined, and nothing was reported
+    REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+    REQUIRE(reported == 0);
+}
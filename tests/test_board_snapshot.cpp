@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Snapshot round-trips a position") {
+    ChessBoard board;
+    board.initialize();
+    board.movePiece(4, 6, 4, 4); // e2 e4
+    board.movePiece(3, 1, 3, 3); // d7 d5
+
+    BoardSnapshot snapshot = board.snapshot();
+    REQUIRE(snapshot.pieceAt(4, 4) == Piece(Color::White, PieceType::Pawn));
+    REQUIRE(snapshot.pieceAt(4, 6).isEmpty());
+    REQUIRE(snapshot.side() == Color::White);
+
+    ChessBoard copy;
+    copy.restore(snapshot);
+    REQUIRE(copy.hash() == board.hash());
+    REQUIRE(copy.computeHash() == board.hash());
+    REQUIRE(copy.display() == board.display());
+
+    // Same position, so the same moves
+    MoveList a, b;
+    board.generateLegalMoves(a);
+    copy.generateLegalMoves(b);
+    REQUIRE(a.size() == b.size());
+}
+
+TEST_CASE("Readers only ever see whole published snapshots") {
+    ChessBoard first;
+    first.initialize();
+    ChessBoard second = first;
+    second.movePiece(6, 7, 5, 5); // g1 f3
+
+    const BoardSnapshot snapshots[2] = { first.snapshot(), second.snapshot() };
+
+    SnapshotPublisher publisher;
+    publisher.publish(snapshots[0]);
+
+    std::atomic<bool> done{ false };
+    std::atomic<int> torn{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                BoardSnapshot s = publisher.read();
+                // The knight's squares must agree with the hash
+                bool isFirst = s.hash == snapshots[0].hash &&
+                               s.pieces == snapshots[0].pieces;
+                bool isSecond = s.hash == snapshots[1].hash &&
+                                s.pieces == snapshots[1].pieces;
+                if (!isFirst && !isSecond)
+                    ++torn;
+            }
+        });
+    }
+
+    for (int i = 0; i < 100000; ++i)
+        publisher.publish(snapshots[i & 1]);
+    done = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    REQUIRE(torn == 0);
+    REQUIRE(publisher.version() == 100001);
+}
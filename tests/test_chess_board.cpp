@@ -97,4 +97,91 @@ TEST_CASE("Checkmate detection (Fool's Mate)") {
 
     REQUIRE(board.isKingInCheck(Color::White));  // Ensure check first
     REQUIRE(board.isCheckmate(Color::White));   // Then checkmate
-}
\ No newline at end of file
+}
+TEST_CASE("Empty squares have no piece") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(board.getPiece(4, 4) == nullptr);                     // E4
+    REQUIRE(board.getPiece(3, 0)->getType() == PieceType::Queen); // Black Queen
+    REQUIRE(board.getPiece(3, 0)->getColor() == Color::Black);
+}
+
+TEST_CASE("Pawn double step cannot jump a piece") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(board.movePiece(6, 7, 5, 5));       // g1 -> f3
+    REQUIRE_FALSE(board.movePiece(5, 6, 5, 4)); // f2 -> f4 blocked by knight
+}
+
+TEST_CASE("Square attack queries") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(board.isSquareAttacked(5, 5, Color::White));       // f3 by g1 knight / pawns
+    REQUIRE_FALSE(board.isSquareAttacked(4, 4, Color::White)); // e4
+    REQUIRE_FALSE(board.isSquareAttacked(4, 4, Color::Black)); // e4
+
+    REQUIRE(board.movePiece(4, 6, 4, 4)); // e2 e4
+    REQUIRE(board.isSquareAttacked(7, 3, Color::White));       // h5 by d1 queen
+}
+
+TEST_CASE("Pieces are one-byte values") {
+    Piece knight(Color::Black, PieceType::Knight);
+    REQUIRE(sizeof(Piece) == 1);
+    REQUIRE(knight.getColor() == Color::Black);
+    REQUIRE(knight.getType() == PieceType::Knight);
+    REQUIRE(knight.symbol() == 'n');
+    REQUIRE(knight.isValidMove(1, 0, 2, 2));
+    REQUIRE_FALSE(knight.isValidMove(1, 0, 1, 2));
+    REQUIRE(Piece().isEmpty());
+}
+
+TEST_CASE("Copied boards are independent") {
+    ChessBoard board;
+    board.initialize();
+
+    ChessBoard copy = board;
+    REQUIRE(copy.movePiece(4, 6, 4, 4)); // E2 -> E4
+
+    REQUIRE(board.getPiece(4, 6)->getType() == PieceType::Pawn);
+    REQUIRE(board.getPiece(4, 4) == nullptr);
+    REQUIRE(copy.getPiece(4, 6) == nullptr);
+    REQUIRE(copy.getPiece(4, 4)->getType() == PieceType::Pawn);
+    REQUIRE(copy.hash() != board.hash());
+}
+
+TEST_CASE("Repetitions reach back into the game played before the search") {
+    ChessBoard board;
+    board.initialize();
+
+    // Knights out and back: the start position again
+    REQUIRE(board.movePiece(6, 7, 5, 5)); // G1 -> F3
+    REQUIRE(board.movePiece(6, 0, 5, 2)); // G8 -> F6
+    REQUIRE(board.movePiece(5, 5, 6, 7)); // F3 -> G1
+    REQUIRE_FALSE(board.isRepetition());
+    REQUIRE(board.movePiece(5, 2, 6, 0)); // F6 -> G8
+    REQUIRE(board.isRepetition());
+    REQUIRE(board.ply() == 0);
+
+    // The same, half in the game and half in a search line
+    board.initialize();
+    REQUIRE(board.movePiece(6, 7, 5, 5)); // G1 -> F3
+    REQUIRE(board.movePiece(6, 0, 5, 2)); // G8 -> F6
+    board.makeMove(board.findMove(5, 5, 6, 7)); // F3 -> G1
+    REQUIRE_FALSE(board.isRepetition());
+    board.makeMove(board.findMove(5, 2, 6, 0)); // F6 -> G8
+    REQUIRE(board.isRepetition());
+    board.unmakeMove();
+    board.unmakeMove();
+
+    // A pawn move starts over, from the position it made
+    REQUIRE(board.movePiece(4, 6, 4, 4)); // E2 -> E4
+    REQUIRE(board.movePiece(5, 2, 6, 0)); // F6 -> G8
+    REQUIRE(board.movePiece(5, 5, 6, 7)); // F3 -> G1
+    REQUIRE(board.movePiece(6, 0, 5, 2)); // G8 -> F6
+    REQUIRE_FALSE(board.isRepetition());
+    REQUIRE(board.movePiece(6, 7, 5, 5)); // G1 -> F3
+    REQUIRE(board.isRepetition());
+}
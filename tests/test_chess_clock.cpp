@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+#include "game/game.hpp"
+
+#include <memory>
+
+struct Player {};
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Clock charges the mover and adds the increment") {
+    ChessClock clock({ 60s, 2s, 0s });
+    auto t0 = ChessClock::Clock::now();
+    clock.start(t0);
+
+    REQUIRE(clock.remaining(Color::White, t0 + 10s) == 50s);
+    REQUIRE(clock.remaining(Color::Black, t0 + 10s) == 60s);
+
+    REQUIRE(clock.press(Color::White, t0 + 10s));
+    REQUIRE(clock.remaining(Color::White, t0 + 30s) == 52s);
+    REQUIRE(clock.remaining(Color::Black, t0 + 30s) == 40s);
+    REQUIRE(clock.flagTime() == t0 + 70s);
+
+    REQUIRE_FALSE(clock.hasFlagged(t0 + 69s));
+    REQUIRE(clock.hasFlagged(t0 + 70s));
+    REQUIRE_FALSE(clock.press(Color::Black, t0 + 71s));
+}
+
+TEST_CASE("Delay is spent before the clock runs") {
+    ChessClock clock({ 10s, 0s, 3s });
+    auto t0 = ChessClock::Clock::now();
+    clock.start(t0);
+
+    REQUIRE(clock.remaining(Color::White, t0 + 2s) == 10s);
+    REQUIRE(clock.press(Color::White, t0 + 5s));
+    REQUIRE(clock.remaining(Color::White, t0 + 5s) == 8s);
+    REQUIRE(clock.flagTime() == t0 + 5s + 3s + 10s);
+}
+
+TEST_CASE("A flag ends the game once") {
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    Game game(1, table, boost::asio::make_strand(io), { 1s, 0s, 0s });
+
+    auto t0 = ChessClock::Clock::now();
+    game.seat(std::make_shared<Player>(), t0);
+    game.seat(std::make_shared<Player>(), t0);
+
+    REQUIRE(game.play(Color::White, 4, 6, 4, 4, PieceType::Queen, t0 + 500ms)
+            == MoveOutcome::Played);
+    REQUIRE_FALSE(game.checkFlag(t0 + 1400ms));
+    REQUIRE(game.play(Color::Black, 4, 1, 4, 3, PieceType::Queen, t0 + 1600ms)
+            == MoveOutcome::OutOfTime);
+
+    REQUIRE(game.isOver());
+    REQUIRE(game.timedOut());
+    REQUIRE(game.board().sideToMove() == Color::Black);
+    REQUIRE_FALSE(game.checkFlag(t0 + 2s));
+}
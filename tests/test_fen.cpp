@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "chess/perft.hpp"
+
+#include <string>
+
+namespace {
+
+constexpr const char* kStart = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr const char* kKiwipete =
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+std::string fenOf(const ChessBoard& board) {
+    char out[ChessBoard::kMaxFEN];
+    std::size_t length = board.toFEN(out);
+    return std::string(out, length);
+}
+
+} // namespace
+
+TEST_CASE("FEN of the starting position, both ways") {
+    ChessBoard board;
+    board.initialize();
+    REQUIRE(fenOf(board) == kStart);
+
+    ChessBoard loaded;
+    REQUIRE(loaded.fromFEN(kStart));
+    REQUIRE(loaded.hash() == board.hash());
+    REQUIRE(perft(loaded, 3) == 8902);
+}
+
+TEST_CASE("FEN positions give the known perft counts") {
+    ChessBoard board;
+
+    REQUIRE(board.fromFEN(kKiwipete));
+    REQUIRE(fenOf(board) == kKiwipete);
+    REQUIRE(board.hash() == board.computeHash());
+    REQUIRE(perft(board, 1) == 48);
+    REQUIRE(perft(board, 2) == 2039);
+    REQUIRE(perft(board, 3) == 97862);
+
+    REQUIRE(board.fromFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"));
+    REQUIRE(perft(board, 4) == 43238);
+
+    REQUIRE(board.fromFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"));
+    REQUIRE(perft(board, 3) == 9467);
+
+    REQUIRE(board.fromFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"));
+    REQUIRE(perft(board, 3) == 62379);
+}
+
+TEST_CASE("Move counters follow the moves") {
+    ChessBoard board;
+    board.initialize();
+
+    board.playMove(board.findMove(6, 7, 5, 5));   // Nf3
+    REQUIRE(board.halfmoveClock() == 1);
+    REQUIRE(board.fullmoveNumber() == 1);
+
+    board.makeMove(board.findMove(6, 0, 5, 2));   // Nf6
+    REQUIRE(board.halfmoveClock() == 2);
+    REQUIRE(board.fullmoveNumber() == 2);
+
+    board.makeMove(board.findMove(4, 6, 4, 4));   // e4 resets the clock
+    REQUIRE(board.halfmoveClock() == 0);
+    REQUIRE(fenOf(board) == "rnbqkb1r/pppppppp/5n2/8/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 0 2");
+
+    board.unmakeMove();
+    board.unmakeMove();
+    REQUIRE(board.halfmoveClock() == 1);
+    REQUIRE(board.fullmoveNumber() == 1);
+}
+
+TEST_CASE("The last move number a FEN can hold survives a move and its unmake") {
+    // The counter stops at 65535, so the unmake must not take one off
+    constexpr const char* kLast = "4k3/8/8/8/8/8/8/4K3 b - - 0 65535";
+    ChessBoard board;
+    REQUIRE(board.fromFEN(kLast));
+
+    board.makeMove(board.findMove(4, 0, 3, 0));   // Kd8
+    REQUIRE(board.fullmoveNumber() == 65535);
+    board.unmakeMove();
+    REQUIRE(board.fullmoveNumber() == 65535);
+    REQUIRE(fenOf(board) == kLast);
+}
+
+TEST_CASE("FEN keeps only what play could use") {
+    ChessBoard board;
+
+    // Nothing can take on e3, so the square is dropped, as after 1. e4
+    REQUIRE(board.fromFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"));
+    REQUIRE(fenOf(board) == "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+
+    // Here d4 can take on e3
+    REQUIRE(board.fromFEN("4k3/8/8/8/3pP3/8/8/4K3 b - e3 0 1"));
+    REQUIRE(fenOf(board) == "4k3/8/8/8/3pP3/8/8/4K3 b - e3 0 1");
+
+    // Rights without the rook at home go; counters may be left out
+    REQUIRE(board.fromFEN("4k3/8/8/8/8/8/8/4K2R w KQ -"));
+    REQUIRE(fenOf(board) == "4k3/8/8/8/8/8/8/4K2R w K - 0 1");
+}
+
+TEST_CASE("Bad FEN is rejected and leaves the board alone") {
+    ChessBoard board;
+    board.initialize();
+    std::uint64_t hash = board.hash();
+
+    const char* bad[] = {
+        "",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",               // 7 ranks
+        "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",      // 9 files
+        "rnbqkbnr/ppppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",     // 9 pieces
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w KQkq - 0 1",      // no such piece
+        "rnbq1bnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQ - 0 1",        // no black king
+        "Pnbqkbnr/pppppppp/8/8/8/8/1PPPPPPP/RNBQKBNR w KQkq - 0 1",      // pawn on rank 8
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1",      // side
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkx - 0 1",      // castling
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 0 1",     // en passant rank
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - x 1",      // halfmove
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 0",      // fullmove
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 x",    // trailing
+        "4k3/4R3/8/8/8/8/8/4K3 w - - 0 1",                               // Black left in check
+    };
+
+    for (const char* fen : bad) {
+        INFO(fen);
+        REQUIRE_FALSE(board.fromFEN(fen));
+        REQUIRE(board.hash() == hash);
+    }
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+#include "networking/frame_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Delivers bytes the way a socket would: as much as fits per read
+void receive(FrameBuffer<32>& buffer, const char* bytes) {
+    std::size_t left = std::strlen(bytes);
+    while (left > 0) {
+        buffer.prepare();
+        std::size_t n = std::min(left, buffer.writeSize());
+        REQUIRE(n > 0);
+        std::memcpy(buffer.writeData(), bytes, n);
+        buffer.commit(n);
+        bytes += n;
+        left -= n;
+    }
+}
+
+std::vector<std::string> lines(FrameBuffer<32>& buffer) {
+    std::vector<std::string> out;
+    std::string_view line;
+    while (buffer.nextLine(line))
+        out.emplace_back(line);
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Frame buffer splits coalesced commands") {
+    FrameBuffer<32> buffer;
+    receive(buffer, "MOVE E2 E4\nANALYZE\r\n");
+    REQUIRE(lines(buffer) == std::vector<std::string>{ "MOVE E2 E4", "ANALYZE" });
+    REQUIRE(lines(buffer).empty());
+}
+
+TEST_CASE("Frame buffer joins a command split across reads") {
+    FrameBuffer<32> buffer;
+    receive(buffer, "MOVE E");
+    REQUIRE(lines(buffer).empty());
+    receive(buffer, "2 E4\nMO");
+    REQUIRE(lines(buffer) == std::vector<std::string>{ "MOVE E2 E4" });
+
+    // Wrapping past the end of the buffer many times over
+    for (int i = 0; i < 50; ++i) {
+        receive(buffer, "VE G1 F3\nMO");
+        REQUIRE(lines(buffer) == std::vector<std::string>{ "MOVE G1 F3" });
+    }
+}
+
+TEST_CASE("Frame buffer reports a line that can never fit") {
+    FrameBuffer<32> buffer;
+    receive(buffer, "0123456789012345678901234567890"); // 31 bytes, no newline
+    receive(buffer, "1");
+    buffer.prepare();
+    REQUIRE(buffer.overflowed());
+    buffer.clear();
+    REQUIRE_FALSE(buffer.overflowed());
+}
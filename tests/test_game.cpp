@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+#include "game/game_registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct Player {};
+
+TEST_CASE("Registry opens a game per connection") {
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    GameRegistry registry(table, io);
+
+    auto first = registry.openGame();
+    REQUIRE(first->seat(std::make_shared<Player>()) == Color::White);
+
+    auto second = registry.openGame();
+    REQUIRE(second != first);
+    REQUIRE(second->seat(std::make_shared<Player>()) == Color::White);
+
+    // The matchmaker brings the opponent over
+    REQUIRE(first->seat(std::make_shared<Player>()) == Color::Black);
+    REQUIRE(first->isFull());
+
+    REQUIRE(registry.size() == 2);
+    REQUIRE(registry.find(first->id()) == first);
+
+    registry.remove(first->id());
+    REQUIRE(registry.find(first->id()) == nullptr);
+    REQUIRE(registry.size() == 1);
+}
+
+TEST_CASE("Players only move their own pieces, on their turn") {
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    Game game(1, table, boost::asio::make_strand(io));
+
+    REQUIRE(game.play(Color::White, 4, 6, 4, 4) == MoveOutcome::WaitingForOpponent);
+
+    game.seat(std::make_shared<Player>());
+    game.seat(std::make_shared<Player>());
+
+    REQUIRE(game.play(Color::Black, 4, 1, 4, 3) == MoveOutcome::NotYourTurn);
+    REQUIRE(game.play(Color::White, 4, 1, 4, 3) == MoveOutcome::NotYourPiece); // e7 e5
+    REQUIRE(game.play(Color::White, 4, 6, 4, 3) == MoveOutcome::Illegal);      // e2 e5
+    REQUIRE(game.play(Color::White, 4, 6, 4, 4) == MoveOutcome::Played);       // e2 e4
+    REQUIRE(game.play(Color::Black, 3, 6, 3, 4) == MoveOutcome::NotYourPiece); // d2 d4
+    REQUIRE(game.play(Color::Black, 4, 1, 4, 3) == MoveOutcome::Played);       // e7 e5
+
+    REQUIRE(game.snapshots().read().hash == game.board().hash());
+}
+
+TEST_CASE("Mate and abandonment end the game") {
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    Game game(1, table, boost::asio::make_strand(io));
+    game.seat(std::make_shared<Player>());
+    game.seat(std::make_shared<Player>());
+
+    REQUIRE(game.play(Color::White, 5, 6, 5, 5) == MoveOutcome::Played); // f2 f3
+    REQUIRE(game.play(Color::Black, 4, 1, 4, 3) == MoveOutcome::Played); // e7 e5
+    REQUIRE(game.play(Color::White, 6, 6, 6, 4) == MoveOutcome::Played); // g2 g4
+    REQUIRE(game.play(Color::Black, 3, 0, 7, 4) == MoveOutcome::Played); // Qd8 h4#
+
+    REQUIRE(game.status() == GameStatus::Checkmate);
+    REQUIRE(game.isOver());
+    REQUIRE(game.play(Color::White, 0, 6, 0, 5) == MoveOutcome::GameOver);
+
+    Game abandoned(2, table, boost::asio::make_strand(io));
+    abandoned.seat(std::make_shared<Player>());
+    abandoned.seat(std::make_shared<Player>());
+    abandoned.leave(Color::Black);
+    REQUIRE(abandoned.isOver());
+    REQUIRE_FALSE(abandoned.isEmpty());
+}
+
+TEST_CASE("Spectators come and go without taking a seat") {
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    Game game(1, table, boost::asio::make_strand(io));
+
+    auto first = std::make_shared<Player>();
+    auto second = std::make_shared<Player>();
+    auto third = std::make_shared<Player>();
+    game.watch(first);
+    game.watch(second);
+    game.watch(third);
+
+    REQUIRE(game.isEmpty());
+    REQUIRE(game.spectators().size() == 3);
+
+    game.unwatch(first.get());
+    game.unwatch(first.get()); // already gone
+    REQUIRE(game.spectators().size() == 2);
+
+    game.unwatch(third.get());
+    REQUIRE(game.spectators().size() == 1);
+    REQUIRE(game.spectators()[0] == second);
+}
+
+TEST_CASE("Other threads read a game's position from its snapshots") {
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    Game game(1, table, boost::asio::make_strand(io));
+    game.seat(std::make_shared<Player>());
+    game.seat(std::make_shared<Player>());
+
+    // Knights out and back, over and over: (fx, fy, tx, ty) per ply
+    const int shuffle[4][4] = { { 6, 7, 5, 5 }, { 6, 0, 5, 2 }, { 5, 5, 6, 7 }, { 5, 2, 6, 0 } };
+    std::vector<std::uint64_t> keys;
+    ChessBoard board;
+    board.initialize();
+    keys.push_back(board.hash());
+    for (const auto& m : shuffle) {
+        board.movePiece(m[0], m[1], m[2], m[3]);
+        keys.push_back(board.hash());
+    }
+
+    constexpr int kPlies = 2000;
+    for (int ply = 0; ply < kPlies; ++ply) {
+        const auto& m = shuffle[ply % 4];
+        boost::asio::post(game.strand(), [&game, &m] {
+            Color side = game.board().sideToMove();
+            REQUIRE(game.play(side, m[0], m[1], m[2], m[3]) == MoveOutcome::Played);
+        });
+    }
+
+    // The reader never waits for the strand and never sees a torn position
+    std::atomic<bool> torn{ false };
+    std::thread reader([&] {
+        std::uint64_t published = game.snapshots().version();
+        while (published < kPlies + 1) {
+            BoardSnapshot snapshot = game.snapshots().read();
+            if (std::find(keys.begin(), keys.end(), snapshot.hash) == keys.end())
+                torn = true;
+            published = game.snapshots().version();
+        }
+    });
+    io.run();
+    reader.join();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(game.snapshots().read().hash == game.board().hash());
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+#include "game/matchmaker.hpp"
+
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+Seeker seeker(int rating, Matchmaker::Clock::time_point since,
+              TimeControl control = {}) {
+    Seeker s;
+    s.rating = rating;
+    s.since = since;
+    s.timeControl = control;
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("Matchmaker pairs close ratings first, far ones after a wait") {
+    Matchmaker matchmaker;
+    auto t0 = Matchmaker::Clock::now();
+
+    matchmaker.enqueue(seeker(1500, t0));
+    matchmaker.enqueue(seeker(2100, t0 + 1s));
+    Matchmaker::Ticket third = matchmaker.enqueue(seeker(1530, t0 + 2s));
+
+    std::vector<Match> matches;
+    matchmaker.tick(t0 + 2s, matches);
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].host.rating == 1500);   // waited longer
+    REQUIRE(matches[0].guest.ticket == third);
+    REQUIRE(matchmaker.waiting() == 1);
+
+    // Nobody to pair with, however long the wait
+    matchmaker.tick(t0 + 60s, matches);
+    REQUIRE(matches.size() == 1);
+
+    // 600 apart: acceptable once one side has waited about 5.5 seconds
+    matches.clear();
+    matchmaker.enqueue(seeker(1500, t0 + 3s));
+    matchmaker.tick(t0 + 7s, matches);
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].host.rating == 2100);
+
+    Matchmaker::Stats stats = matchmaker.stats();
+    REQUIRE(stats.matches == 2);
+    REQUIRE(stats.waiting == 0);
+    REQUIRE(stats.max == 6s);
+}
+
+TEST_CASE("Matchmaker keeps time controls apart and forgets cancelled seeks") {
+    Matchmaker matchmaker;
+    auto t0 = Matchmaker::Clock::now();
+
+    matchmaker.enqueue(seeker(1500, t0, { 5min, 3s, 0s }));
+    matchmaker.enqueue(seeker(1500, t0, { 1min, 0s, 0s }));
+    Matchmaker::Ticket gone = matchmaker.enqueue(seeker(1500, t0, { 1min, 0s, 0s }));
+    REQUIRE(matchmaker.cancel(gone));
+    REQUIRE_FALSE(matchmaker.cancel(gone));
+
+    std::vector<Match> matches;
+    matchmaker.tick(t0 + 30s, matches);
+    REQUIRE(matches.empty());
+    REQUIRE(matchmaker.waiting() == 2);
+
+    matchmaker.enqueue(seeker(1700, t0 + 30s, { 1min, 0s, 0s }));
+    matchmaker.tick(t0 + 30s, matches);
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].host.timeControl.base == 1min);
+}
+
+TEST_CASE("Matchmaker drops the pools nobody waits in") {
+    Matchmaker matchmaker;
+    auto t0 = Matchmaker::Clock::now();
+
+    // A flood of odd time controls, all cancelled
+    std::vector<Matchmaker::Ticket> tickets;
+    for (int i = 0; i < 1000; ++i) {
+        TimeControl odd{ std::chrono::seconds(60 + i), std::chrono::seconds(i % 7), 0s };
+        tickets.push_back(matchmaker.enqueue(seeker(1500, t0, odd)));
+    }
+    REQUIRE(matchmaker.pools() == 1000);
+    for (Matchmaker::Ticket ticket : tickets)
+        matchmaker.cancel(ticket);
+
+    // One pool paired empty, one still waiting
+    matchmaker.enqueue(seeker(1500, t0, { 5min, 0s, 0s }));
+    matchmaker.enqueue(seeker(1510, t0, { 5min, 0s, 0s }));
+    matchmaker.enqueue(seeker(1500, t0, { 3min, 2s, 0s }));
+
+    std::vector<Match> matches;
+    matchmaker.tick(t0 + 1s, matches);
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matchmaker.pools() == 1);
+    REQUIRE(matchmaker.waiting() == 1);
+}
+
+TEST_CASE("Time controls parse as minutes plus seconds") {
+    TimeControl control;
+    REQUIRE(parseTimeControl("5+3", control));
+    REQUIRE(control.base == 5min);
+    REQUIRE(control.increment == 3s);
+
+    REQUIRE(parseTimeControl("0.5", control));
+    REQUIRE(control.base == 30s);
+    REQUIRE(control.increment == 0s);
+
+    REQUIRE_FALSE(parseTimeControl("fast", control));
+    REQUIRE_FALSE(parseTimeControl("5+", control));
+    REQUIRE_FALSE(parseTimeControl("5+3x", control));
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "chess/perft.hpp"
+
+TEST_CASE("Perft from the starting position") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(perft(board, 1) == 20);
+    REQUIRE(perft(board, 2) == 400);
+    REQUIRE(perft(board, 3) == 8902);
+    REQUIRE(perft(board, 4) == 197281);
+}
+
+TEST_CASE("Side to move flips after each move") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(board.sideToMove() == Color::White);
+    REQUIRE(board.movePiece(4, 6, 4, 4)); // e2 e4
+    REQUIRE(board.sideToMove() == Color::Black);
+}
+
+TEST_CASE("En passant is generated right after the double step") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(board.movePiece(4, 6, 4, 4)); // e2 e4
+    REQUIRE(board.movePiece(0, 1, 0, 2)); // a7 a6
+    REQUIRE(board.movePiece(4, 4, 4, 3)); // e4 e5
+    REQUIRE(board.movePiece(3, 1, 3, 3)); // d7 d5
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+
+    bool found = false;
+    for (Move move : moves)
+        if (move.flag() == Move::EnPassant && move.toString() == "e5d6")
+            found = true;
+    REQUIRE(found);
+
+    REQUIRE(board.movePiece(4, 3, 3, 2));   // e5xd6 e.p.
+    REQUIRE(board.getPiece(3, 3) == nullptr); // d5 pawn removed
+}
+
+TEST_CASE("Pawn promotion") {
+    ChessBoard board;
+    board.initialize();
+
+    // h-pawn marches and captures its way to g8
+    REQUIRE(board.movePiece(7, 6, 7, 4)); // h2 h4
+    REQUIRE(board.movePiece(6, 1, 6, 3)); // g7 g5
+    REQUIRE(board.movePiece(7, 4, 6, 3)); // h4xg5
+    REQUIRE(board.movePiece(7, 1, 7, 2)); // h7 h6
+    REQUIRE(board.movePiece(6, 3, 7, 2)); // g5xh6
+    REQUIRE(board.movePiece(0, 1, 0, 2)); // a7 a6
+    REQUIRE(board.movePiece(7, 2, 7, 1)); // h6 h7
+    REQUIRE(board.movePiece(0, 2, 0, 3)); // a6 a5
+    REQUIRE(board.movePiece(7, 1, 6, 0, PieceType::Knight)); // h7xg8=N
+
+    REQUIRE(board.getPiece(6, 0)->getType() == PieceType::Knight);
+    REQUIRE(board.getPiece(6, 0)->getColor() == Color::White);
+}
+
+TEST_CASE("Starting position is neither stalemate nor checkmate") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE_FALSE(board.isStalemate(Color::White));
+    REQUIRE_FALSE(board.isCheckmate(Color::White));
+}
+
+TEST_CASE("Unmake restores the position exactly") {
+    ChessBoard board;
+    board.initialize();
+
+    // Reach a position with castling, en passant and captures available
+    REQUIRE(board.movePiece(4, 6, 4, 4)); // e2 e4
+    REQUIRE(board.movePiece(3, 1, 3, 3)); // d7 d5
+    REQUIRE(board.movePiece(4, 4, 4, 3)); // e4 e5
+    REQUIRE(board.movePiece(5, 1, 5, 3)); // f7 f5 (e5xf6 e.p. possible)
+    REQUIRE(board.movePiece(6, 7, 5, 5)); // g1 f3
+    REQUIRE(board.movePiece(6, 0, 7, 2)); // g8 h6
+    REQUIRE(board.movePiece(5, 7, 2, 4)); // f1 c4 (O-O possible)
+    REQUIRE(board.movePiece(3, 3, 2, 4)); // d5xc4
+
+    std::string before = board.display();
+    std::uint64_t nodes = perft(board, 3);
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (Move move : moves) {
+        board.makeMove(move);
+        board.unmakeMove();
+        REQUIRE(board.display() == before);
+    }
+
+    REQUIRE(board.ply() == 0);
+    REQUIRE(perft(board, 3) == nodes);
+}
+
+namespace {
+
+// Walks the tree checking the incremental key against a full recompute
+void checkHashes(ChessBoard& board, int depth) {
+    REQUIRE(board.hash() == board.computeHash());
+    if (depth == 0)
+        return;
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (Move move : moves) {
+        board.makeMove(move);
+        checkHashes(board, depth - 1);
+        board.unmakeMove();
+    }
+}
+
+} // namespace
+
+TEST_CASE("Zobrist key is maintained incrementally") {
+    ChessBoard board;
+    board.initialize();
+
+    REQUIRE(board.movePiece(4, 6, 4, 4)); // e2 e4
+    REQUIRE(board.movePiece(3, 1, 3, 3)); // d7 d5
+    REQUIRE(board.movePiece(4, 4, 4, 3)); // e4 e5
+    REQUIRE(board.movePiece(5, 1, 5, 3)); // f7 f5, e.p. available
+
+    checkHashes(board, 3);
+}
+
+TEST_CASE("Transpositions share a Zobrist key") {
+    ChessBoard a, b;
+    a.initialize();
+    b.initialize();
+
+    REQUIRE(a.movePiece(6, 7, 5, 5)); // Nf3
+    REQUIRE(a.movePiece(6, 0, 5, 2)); // Nf6
+    REQUIRE(a.movePiece(1, 7, 2, 5)); // Nc3
+
+    REQUIRE(b.movePiece(1, 7, 2, 5)); // Nc3
+    REQUIRE(b.movePiece(6, 0, 5, 2)); // Nf6
+    REQUIRE(b.movePiece(6, 7, 5, 5)); // Nf3
+
+    REQUIRE(a.hash() == b.hash());
+
+    ChessBoard c;
+    c.initialize();
+    REQUIRE(c.hash() != a.hash());
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+#include "game/game_registry.hpp"
+#include "game/move_log.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <random>
+
+struct Player {};
+
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+// A fresh directory, removed again at the end of the test
+struct TempDirectory {
+    fs::path path = fs::temp_directory_path() /
+                    ("chessy-move-log-" + std::to_string(std::random_device{}()));
+    ~TempDirectory() { fs::remove_all(path); }
+};
+
+} // namespace
+
+TEST_CASE("Move log brings back the games that did not finish") {
+    TempDirectory dir;
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+    TimeControl control{ 300s, 2s, 0s };
+
+    Game game(1, table, boost::asio::make_strand(io), control);
+    game.seat(std::make_shared<Player>());
+    game.seat(std::make_shared<Player>());
+    std::atomic<int> durable{ 0 };
+
+    {
+        MoveLog log(dir.path.string(), 2);
+        log.logStart(1, control, 11, 12);
+        log.logStart(2, control, 21, 22);
+
+        REQUIRE(game.play(Color::White, 4, 6, 4, 4) == MoveOutcome::Played); // e2 e4
+        log.logMove(1, game.lastMove(), 301s, [&] { ++durable; });
+        REQUIRE(game.play(Color::Black, 4, 1, 4, 3) == MoveOutcome::Played); // e7 e5
+        log.logMove(1, game.lastMove(), 299s, [&] { ++durable; });
+
+        log.logEnd(2);
+    }
+    REQUIRE(durable == 2);
+
+    std::vector<LoggedGame> logged = MoveLog::recover(dir.path.string());
+    REQUIRE(logged.size() == 1);
+    REQUIRE(logged[0].id == 1);
+    REQUIRE(logged[0].moves.size() == 2);
+    REQUIRE(logged[0].resumeKeys[0] == 11);
+    REQUIRE(logged[0].clockLeft[1] == 299s);
+
+    // Replayed, it waits for its players with the clocks as they were
+    GameRegistry registry(table, io);
+    auto restored = registry.restore(logged, 2);
+    REQUIRE(restored[0]);
+    REQUIRE(restored[0]->board().hash() == game.board().hash());
+    REQUIRE(restored[0]->awaitingReturn());
+    REQUIRE(restored[0]->resumeKey(Color::Black) == 12);
+    REQUIRE(registry.openGame()->id() == 2);
+
+    auto t0 = ChessClock::Clock::now();
+    restored[0]->reseat(std::make_shared<Player>(), Color::Black, t0);
+    REQUIRE_FALSE(restored[0]->clock().running());
+    restored[0]->reseat(std::make_shared<Player>(), Color::White, t0);
+    REQUIRE(restored[0]->clock().running());
+    REQUIRE(restored[0]->clock().remaining(Color::White, t0 + 1s) == 300s);
+    REQUIRE(restored[0]->play(Color::White, 6, 7, 5, 5, PieceType::Queen, t0 + 1s) ==
+            MoveOutcome::Played); // g1 f3
+}
+
+TEST_CASE("Recovery stops where a crash cut the log short") {
+    TempDirectory dir;
+    TranspositionTable table(1);
+    boost::asio::io_context io;
+
+    Game game(7, table, boost::asio::make_strand(io));
+    game.seat(std::make_shared<Player>());
+    game.seat(std::make_shared<Player>());
+
+    {
+        MoveLog log(dir.path.string(), 1);
+        log.logStart(7, {}, 1, 2);
+        game.play(Color::White, 3, 6, 3, 4);  // d2 d4
+        log.logMove(7, game.lastMove(), 0ms, {});
+        game.play(Color::Black, 3, 1, 3, 3);  // d7 d5
+        log.logMove(7, game.lastMove(), 0ms, {});
+    }
+
+    // Half of the last record made it to disk
+    fs::path file = dir.path / "moves-0.wal";
+    fs::resize_file(file, fs::file_size(file) - 7);
+
+    std::vector<LoggedGame> logged = MoveLog::recover(dir.path.string());
+    REQUIRE(logged.size() == 1);
+    REQUIRE(logged[0].moves.size() == 1);
+
+    // Reopening rewrites the log without the torn tail, and without the
+    // shards a larger count left behind
+    { MoveLog log(dir.path.string(), 3, logged); }
+    { MoveLog log(dir.path.string(), 1, MoveLog::recover(dir.path.string())); }
+    REQUIRE_FALSE(fs::exists(dir.path / "moves-2.wal"));
+
+    logged = MoveLog::recover(dir.path.string());
+    REQUIRE(logged.size() == 1);
+    REQUIRE(logged[0].moves.size() == 1);
+    REQUIRE(fs::file_size(file) == 41 + 19);
+}
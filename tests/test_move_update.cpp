@@ -0,0 +1,50 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/move_update.hpp"
+
+TEST_CASE("Move updates round-trip as text") {
+    MoveUpdate update;
+    update.move = Move::fromString("e7e8q");
+    update.sideToMove = Color::Black;
+    update.status = GameStatus::Checkmate;
+    update.hash = 0x0123456789abcdefULL;
+
+    std::string line = formatMoveUpdate(update);
+    REQUIRE(line == "MOVED e7e8q BLACK CHECKMATE 0123456789abcdef\n");
+
+    MoveUpdate parsed;
+    REQUIRE(parseMoveUpdate(line.substr(0, line.size() - 1), parsed));
+    REQUIRE(parsed.move == update.move);
+    REQUIRE(parsed.sideToMove == Color::Black);
+    REQUIRE(parsed.status == GameStatus::Checkmate);
+    REQUIRE(parsed.hash == update.hash);
+
+    REQUIRE_FALSE(parseMoveUpdate("MOVED e9e4 WHITE ONGOING 0", parsed));
+    REQUIRE_FALSE(parseMoveUpdate("Move successful!", parsed));
+}
+
+TEST_CASE("A mirror board follows updates and detects divergence") {
+    ChessBoard server, mirror;
+    server.initialize();
+    mirror.initialize();
+
+    Move move = server.findMove(4, 6, 4, 4); // e2 e4
+    server.playMove(move);
+
+    MoveUpdate update{ move, server.sideToMove(), server.status(), server.hash() };
+    REQUIRE(applyMoveUpdate(mirror, update));
+    REQUIRE(mirror.hash() == server.hash());
+
+    // A mirror that missed a move cannot follow the next one
+    server.movePiece(4, 1, 4, 3); // e7 e5
+    server.playMove(server.findMove(6, 7, 5, 5)); // g1 f3
+    update = { Move::fromString("g1f3"), server.sideToMove(), server.status(), server.hash() };
+    REQUIRE_FALSE(applyMoveUpdate(mirror, update));
+
+    // ... until it is resynced from the packed position
+    PackedPosition packed;
+    REQUIRE(parsePosition(formatPosition(packPosition(server.snapshot())), packed));
+    BoardSnapshot snapshot;
+    REQUIRE(unpackPosition(packed, snapshot));
+    mirror.restore(snapshot);
+    REQUIRE(mirror.hash() == server.hash());
+}
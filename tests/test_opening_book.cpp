@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/pgn.hpp"
+#include "engine/opening_book.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Three 1. e4 games (two won by White, one drawn), one 1. d4 game lost by
+// White, and a game that castles on move 4
+constexpr const char* kGames = R"([Result "1-0"]
+
+1. e4 e5 2. Nf3 Nc6 1-0
+
+[Result "1-0"]
+
+1. e4 c5 2. Nf3 1-0
+
+[Result "1/2-1/2"]
+
+1. e4 e5 2. Nf3 Nf6 1/2-1/2
+
+[Result "0-1"]
+
+1. d4 d5 0-1
+
+[Result "*"]
+
+1. e4 e5 2. Nf3 Nc6 3. Bc4 Bc5 4. O-O Nf6 *
+
+[Result "1-0"]
+
+1. e4 e5 2. Ke3 1-0
+)";
+
+// A file name in the temp directory, removed again at the end of the test
+struct TempFile {
+    fs::path path = fs::temp_directory_path() /
+                    ("chessy-book-" + std::to_string(std::random_device{}()) + ".bin");
+    ~TempFile() { fs::remove(path); }
+};
+
+BookBuilder buildFrom(std::string_view text, int plies, std::size_t& skipped) {
+    BookBuilder builder(plies);
+    PgnReader reader(text);
+    PgnGame game;
+    ChessBoard board;
+    skipped = 0;
+    while (reader.next(game))
+        skipped += !builder.addGame(game, board);
+    return builder;
+}
+
+} // namespace
+
+TEST_CASE("Opening book weighs moves by how their games went") {
+    TempFile file;
+    std::size_t skipped = 0;
+    BookBuilder builder = buildFrom(kGames, 8, skipped);
+    REQUIRE(skipped == 1); // 2. Ke3 is not legal
+    REQUIRE(builder.games() == 5);
+
+    std::size_t entries = builder.write(file.path.string());
+    REQUIRE(fs::file_size(file.path) == entries * OpeningBook::kEntrySize);
+
+    OpeningBook book(file.path.string());
+    REQUIRE(book.entries() == entries);
+
+    ChessBoard board;
+    board.initialize();
+    OpeningBook::Moves moves;
+
+    // e4: 2 + 2 + 1 + 1; d4 lost, so it is left out
+    REQUIRE(book.lookup(board, moves) == 1);
+    REQUIRE(moves[0].move.toString() == "e2e4");
+    REQUIRE(moves[0].weight == 6);
+
+    // Black's replies: e5 drew once and was played on in an unfinished
+    // game; c5 lost
+    board.playMove(board.fromSAN("e4"));
+    REQUIRE(book.lookup(board, moves) == 1);
+    REQUIRE(moves[0].move.toString() == "e7e5");
+    REQUIRE(moves[0].weight == 2);
+
+    board.playMove(board.fromSAN("e5"));
+    board.playMove(board.fromSAN("Nf3"));
+    REQUIRE(book.lookup(board, moves) == 2);
+    REQUIRE(moves[0].weight == 1);
+    REQUIRE(moves[1].weight == 1);
+    REQUIRE(moves[0].move.toString() != moves[1].move.toString());
+
+    // Out of the book
+    board.playMove(board.fromSAN("a6"));
+    REQUIRE(book.lookup(board, moves) == 0);
+    REQUIRE(book.pick(board, 0).isNull());
+
+    // Fewer games than asked for leave a position out
+    TempFile sparse;
+    REQUIRE(builder.write(sparse.path.string(), 3) < entries);
+    OpeningBook sparseBook(sparse.path.string());
+    board.initialize();
+    REQUIRE(sparseBook.lookup(board, moves) == 1);
+    board.playMove(board.fromSAN("e4"));
+    REQUIRE(sparseBook.lookup(board, moves) == 1);
+    board.playMove(board.fromSAN("e5"));
+    board.playMove(board.fromSAN("Nf3"));
+    REQUIRE(sparseBook.lookup(board, moves) == 0);
+}
+
+TEST_CASE("Opening book moves use the Polyglot encoding") {
+    ChessBoard board;
+    board.initialize();
+
+    // g1f3: to f3 (file 5, rank 2), from g1 (file 6, rank 0)
+    Move knight = board.fromSAN("Nf3");
+    REQUIRE(OpeningBook::encode(knight) == (5 | (2 << 3) | (6 << 6) | (0 << 9)));
+
+    // Castling is the king taking its rook: e1h1, e8a8
+    REQUIRE(board.fromFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1"));
+    REQUIRE(OpeningBook::encode(board.fromSAN("O-O")) == (7 | (0 << 3) | (4 << 6) | (0 << 9)));
+    REQUIRE(board.fromFEN("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1"));
+    REQUIRE(OpeningBook::encode(board.fromSAN("O-O-O")) == (0 | (7 << 3) | (4 << 6) | (7 << 9)));
+
+    // Promotion to a queen is 4
+    REQUIRE(board.fromFEN("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1"));
+    REQUIRE(OpeningBook::encode(board.fromSAN("b8=Q")) >> 12 == 4);
+    REQUIRE(OpeningBook::encode(board.fromSAN("b8=N")) >> 12 == 1);
+
+    // A castling move read back from a book is the board's own castling move
+    TempFile file;
+    std::size_t skipped = 0;
+    buildFrom(kGames, 8, skipped).write(file.path.string());
+    OpeningBook book(file.path.string());
+    board.initialize();
+    for (const char* san : { "e4", "e5", "Nf3", "Nc6", "Bc4", "Bc5" })
+        board.playMove(board.fromSAN(san));
+    OpeningBook::Moves moves;
+    REQUIRE(book.lookup(board, moves) == 1);
+    REQUIRE(moves[0].move.flag() == Move::Castle);
+    REQUIRE(book.pick(board, 12345) == moves[0].move);
+}
+
+TEST_CASE("Opening book keys are Polyglot's") {
+    // The keys published with the Polyglot book format
+    ChessBoard board;
+    board.initialize();
+    REQUIRE(OpeningBook::key(board) == 0x463b96181691fc9cULL);
+
+    const std::pair<const char*, std::uint64_t> line[] = {
+        { "e4", 0x823c9b50fd114196ULL },   // no en-passant key: nothing can take
+        { "d5", 0x0756b94461c50fb0ULL },   // en passant on d6
+        { "e5", 0x662fafb965db29d4ULL },
+        { "f5", 0x22a48b5a8e47ff78ULL },   // en passant on f6
+        { "Ke2", 0x652a607ca3f242c1ULL },  // White's rights gone
+        { "Kf7", 0x00fdd303c946bdd9ULL },  // and Black's
+    };
+    for (const auto& [san, key] : line) {
+        board.playMove(board.fromSAN(san));
+        REQUIRE(OpeningBook::key(board) == key);
+    }
+
+    board.initialize();
+    for (const char* san : { "a4", "b5", "h4", "b4", "c4" })
+        board.playMove(board.fromSAN(san));
+    REQUIRE(OpeningBook::key(board) == 0x3c8123ea7b067637ULL);
+    board.playMove(board.fromSAN("bxc3"));
+    board.playMove(board.fromSAN("Ra3"));
+    REQUIRE(OpeningBook::key(board) == 0x5c3f9b829b279560ULL);
+
+    // The same positions set up from FEN
+    REQUIRE(board.fromFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"));
+    REQUIRE(OpeningBook::key(board) == 0x823c9b50fd114196ULL);
+    REQUIRE(board.fromFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"));
+    REQUIRE(OpeningBook::key(board) == 0x22a48b5a8e47ff78ULL);
+}
+
+TEST_CASE("Opening book rejects files that are not books") {
+    TempFile file;
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "not a book";
+    }
+    REQUIRE_THROWS_AS(OpeningBook(file.path.string()), std::runtime_error);
+
+    fs::remove(file.path);
+    REQUIRE_THROWS_AS(OpeningBook(file.path.string()), std::runtime_error);
+
+    // An empty book is a book with nothing in it
+    std::ofstream(file.path, std::ios::binary).close();
+    OpeningBook empty(file.path.string());
+    ChessBoard board;
+    board.initialize();
+    OpeningBook::Moves moves;
+    REQUIRE(empty.lookup(board, moves) == 0);
+}
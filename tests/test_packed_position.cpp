@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "chess/packed_position.hpp"
+
+namespace {
+
+void requireRoundTrip(const ChessBoard& board) {
+    BoardSnapshot original = board.snapshot();
+    PackedPosition packed = packPosition(original);
+
+    BoardSnapshot unpacked;
+    REQUIRE(unpackPosition(packed, unpacked));
+    REQUIRE(unpacked.pieces == original.pieces);
+    REQUIRE(unpacked.colors == original.colors);
+    REQUIRE(unpacked.castlingRights == original.castlingRights);
+    REQUIRE(unpacked.enPassantSquare == original.enPassantSquare);
+    REQUIRE(unpacked.sideToMove == original.sideToMove);
+    REQUIRE(unpacked.hash == original.hash);
+}
+
+} // namespace
+
+TEST_CASE("Packed position is 24 bytes and round-trips") {
+    REQUIRE(sizeof(PackedPosition) == 24);
+
+    ChessBoard board;
+    board.initialize();
+    requireRoundTrip(board);
+
+    board.movePiece(4, 6, 4, 4); // e2 e4
+    requireRoundTrip(board);     // black to move
+
+    board.movePiece(0, 1, 0, 2); // a7 a6
+    board.movePiece(4, 4, 4, 3); // e4 e5
+    board.movePiece(3, 1, 3, 3); // d7 d5, en passant possible
+    REQUIRE(board.snapshot().enPassantSquare >= 0);
+    requireRoundTrip(board);
+
+    board.movePiece(7, 6, 7, 4); // h2 h4
+    board.movePiece(0, 0, 0, 1); // Ra8 a7, black loses queen-side castling
+    requireRoundTrip(board);
+}
+
+TEST_CASE("Unpacking rejects impossible codes") {
+    PackedPosition packed;
+    packed.bytes[0] = 1;  // a piece on A8
+    packed.bytes[8] = 15; // unused code
+    BoardSnapshot snapshot;
+    REQUIRE_FALSE(unpackPosition(packed, snapshot));
+
+    packed.bytes[0] = 2;  // B8 cannot hold a castling rook
+    packed.bytes[8] = 13;
+    REQUIRE_FALSE(unpackPosition(packed, snapshot));
+}
@@ -0,0 +1,209 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "chess/pgn.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kOperaGame = R"([Event "Casual game"]
+[Site "Paris FRA"]
+[White "Morphy, Paul"]
+[Black "Duke Karl / Count Isouard"]
+[Result "1-0"]
+
+1. e4 e5 2. Nf3 d6 3. d4 Bg4 $6 {Better is} (3... exd4) 4. dxe5 Bxf3 5. Qxf3
+dxe5 6. Bc4 Nf6 7. Qb3 Qe7 8. Nc3 c6 9. Bg5 b5 $2 10. Nxb5! cxb5 11. Bxb5+ Nbd7
+12. O-O-O Rd8 13. Rxd7! Rxd7 14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+!! Nxb8 17. Rd8#
+{The Opera Game.} 1-0
+)";
+
+std::string sanOf(const ChessBoard& board, Move move) {
+    char out[ChessBoard::kMaxSAN];
+    std::size_t length = board.toSAN(move, out);
+    return std::string(out, length);
+}
+
+std::vector<std::string> movesOf(std::string_view movetext) {
+    std::vector<std::string> sans;
+    PgnMoves moves(movetext);
+    std::string_view san;
+    while (moves.next(san))
+        sans.emplace_back(san);
+    return sans;
+}
+
+} // namespace
+
+TEST_CASE("SAN names every legal move, and reads back as that move") {
+    std::mt19937 random(7);
+    ChessBoard board;
+    MoveList moves;
+
+    for (int game = 0; game < 20; ++game) {
+        board.initialize();
+        for (int ply = 0; ply < 120; ++ply) {
+            board.generateLegalMoves(moves);
+            if (moves.empty())
+                break;
+            for (Move move : moves) {
+                std::string san = sanOf(board, move);
+                INFO(san);
+                REQUIRE(san.size() < ChessBoard::kMaxSAN);
+                REQUIRE(board.fromSAN(san) == move);
+            }
+            board.playMove(moves[random() % moves.size()]);
+        }
+    }
+}
+
+TEST_CASE("SAN says which piece when two could go") {
+    ChessBoard board;
+
+    // Knights on b1 and f3 both reach d2
+    REQUIRE(board.fromFEN("4k3/8/8/8/8/5N2/8/1N2K3 w - - 0 1"));
+    Move fromB1 = board.fromSAN("Nbd2");
+    REQUIRE(sanOf(board, fromB1) == "Nbd2");
+    REQUIRE(fromB1.from() == makeSquare(1, 7));
+    REQUIRE(board.fromSAN("Nfd2").from() == makeSquare(5, 5));
+    REQUIRE(board.fromSAN("Nd2").isNull());
+
+    // Rooks on a1 and a5 both reach a3
+    REQUIRE(board.fromFEN("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1"));
+    REQUIRE(sanOf(board, board.fromSAN("R1a3")) == "R1a3");
+    REQUIRE(sanOf(board, board.fromSAN("R5a3")) == "R5a3");
+    REQUIRE(board.fromSAN("Ra3").isNull());
+}
+
+TEST_CASE("SAN castling, promotion and checks") {
+    ChessBoard board;
+
+    REQUIRE(board.fromFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1"));
+    REQUIRE(sanOf(board, board.fromSAN("O-O")) == "O-O");
+    REQUIRE(board.fromSAN("0-0-0") == board.fromSAN("O-O-O"));
+    REQUIRE(board.fromSAN("O-O-O").flag() == Move::Castle);
+    REQUIRE(sanOf(board, board.fromSAN("Ra8")) == "Rxa8+");
+
+    REQUIRE(board.fromFEN("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1"));
+    REQUIRE(sanOf(board, board.fromSAN("b8=Q")) == "b8=Q+");
+    REQUIRE(board.fromSAN("b8Q") == board.fromSAN("b8=Q+"));
+    REQUIRE(board.fromSAN("b8=N").promotion() == PieceType::Knight);
+    REQUIRE(board.fromSAN("b8").isNull());
+
+    // Mate gets '#'
+    REQUIRE(board.fromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"));
+    REQUIRE(sanOf(board, board.fromSAN("Ra8")) == "Ra8#");
+
+    for (const char* bad : { "", "x", "Nz9", "e5", "Ke3", "O-O", "Qxe8" })
+        REQUIRE(board.fromSAN(bad).isNull());
+}
+
+TEST_CASE("PGN reader splits games and reads their tags") {
+    std::string text = std::string("% written by hand\n\n") + kOperaGame +
+        "\n[Event \"Say \\\"hi\\\"\"]\n[FEN \"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1\"]\n"
+        "\n1.e4 ; the end\n(1.e3 {skip (this)}) Kd7 *\n";
+    PgnReader reader{ std::string_view(text) };
+    PgnGame game;
+
+    REQUIRE(reader.next(game));
+    REQUIRE(game.tagCount == 5);
+    REQUIRE(game.tag("White") == "Morphy, Paul");
+    REQUIRE(game.tag("Annotator").empty());
+    REQUIRE(game.text.substr(0, 7) == "[Event ");
+    REQUIRE(game.movetext.substr(0, 9) == "1. e4 e5 ");
+
+    std::vector<std::string> sans = movesOf(game.movetext);
+    REQUIRE(sans.size() == 33);
+    REQUIRE(sans[5] == "Bg4");
+    REQUIRE(sans[6] == "dxe5");
+    REQUIRE(sans.back() == "Rd8#");
+
+    REQUIRE(reader.next(game));
+    REQUIRE(game.tag("Event") == "Say \\\"hi\\\"");
+    REQUIRE(movesOf(game.movetext) == std::vector<std::string>{ "e4", "Kd7" });
+
+    REQUIRE_FALSE(reader.next(game));
+    REQUIRE_FALSE(reader.next(game));
+}
+
+TEST_CASE("PGN games replay to where they ended") {
+    PgnReader reader{ std::string_view(kOperaGame) };
+    PgnGame game;
+    ChessBoard board;
+
+    REQUIRE(reader.next(game));
+    PgnReplay replay = replayGame(game, board);
+    REQUIRE(replay.ok());
+    REQUIRE(replay.plies == 33);
+    REQUIRE(replay.result == "1-0");
+    REQUIRE(board.status() == GameStatus::Checkmate);
+
+    // A move that is not legal stops the replay there
+    std::string_view bad = "[Event \"?\"]\n\n1. e4 e5 2. Ke3 Nc6 *\n";
+    PgnReader badReader(bad);
+    REQUIRE(badReader.next(game));
+    replay = replayGame(game, board);
+    REQUIRE_FALSE(replay.ok());
+    REQUIRE(replay.failed == "Ke3");
+    REQUIRE(replay.plies == 2);
+}
+
+TEST_CASE("PGN reader maps files") {
+    fs::path path = fs::temp_directory_path() /
+                    ("chessy-pgn-" + std::to_string(std::random_device{}()) + ".pgn");
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 3; ++i)
+            out << kOperaGame << "\n";
+    }
+
+    int games = 0;
+    {
+        PgnReader reader(path.string());
+        PgnGame game;
+        ChessBoard board;
+        while (reader.next(game)) {
+            REQUIRE(replayGame(game, board).ok());
+            ++games;
+        }
+    }
+    fs::remove(path);
+
+    REQUIRE(games == 3);
+    REQUIRE_THROWS_AS(PgnReader(path.string()), std::runtime_error);
+}
+
+TEST_CASE("PGN text splits into pieces of whole games") {
+    std::string text;
+    for (int i = 0; i < 10; ++i)
+        text += std::string(kOperaGame) + "\n";
+
+    for (std::size_t parts : { 1, 3, 7, 10, 40 }) {
+        std::vector<std::string_view> pieces = splitGames(text, parts);
+        REQUIRE(pieces.size() <= parts);
+
+        std::string joined;
+        int games = 0;
+        for (std::string_view piece : pieces) {
+            REQUIRE(piece.substr(0, 7) == "[Event ");
+            joined += piece;
+
+            PgnReader reader(piece);
+            PgnGame game;
+            ChessBoard board;
+            while (reader.next(game)) {
+                REQUIRE(replayGame(game, board).ok());
+                ++games;
+            }
+        }
+        REQUIRE(joined == text);
+        REQUIRE(games == 10);
+    }
+}
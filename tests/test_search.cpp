@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "engine/parallel_search.hpp"
+#include "engine/search.hpp"
+
+TEST_CASE("Search finds mate in one") {
+    TranspositionTable table(4);
+    Search search(table);
+
+    ChessBoard board;
+    board.initialize();
+    board.movePiece(5, 6, 5, 5); // f2 f3
+    board.movePiece(4, 1, 4, 3); // e7 e5
+    board.movePiece(6, 6, 6, 4); // g2 g4
+
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    SearchResult result = search.run(board, limits);
+
+    REQUIRE(result.bestMove.toString() == "d8h4");
+    REQUIRE(result.score >= kMateBound);
+}
+
+TEST_CASE("Search takes a hanging queen") {
+    TranspositionTable table(4);
+    Search search(table);
+
+    ChessBoard board;
+    board.initialize();
+    board.movePiece(4, 6, 4, 4); // e2 e4
+    board.movePiece(3, 1, 3, 2); // d7 d6
+    board.movePiece(3, 7, 6, 4); // Qd1 g4??
+
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    SearchResult result = search.run(board, limits);
+
+    REQUIRE(result.bestMove.toString() == "c8g4");
+    REQUIRE(result.nodes > 0);
+}
+
+TEST_CASE("Parallel search agrees with a single thread on a forced mate") {
+    TranspositionTable table(4);
+    ParallelSearch search(table, 4);
+
+    ChessBoard board;
+    board.initialize();
+    board.movePiece(5, 6, 5, 5); // f2 f3
+    board.movePiece(4, 1, 4, 3); // e7 e5
+    board.movePiece(6, 6, 6, 4); // g2 g4
+
+    SearchLimits limits;
+    limits.maxDepth = 5;
+    SearchResult result = search.run(board, limits);
+
+    REQUIRE(search.threads() == 4);
+    REQUIRE(result.bestMove.toString() == "d8h4");
+    REQUIRE(result.score >= kMateBound);
+}
+
+TEST_CASE("Searches count their own table probes") {
+    TranspositionTable table(4);
+    ChessBoard board;
+    board.initialize();
+
+    SearchLimits limits;
+    limits.maxDepth = 5;
+
+    // Each iteration finds the previous one's entries
+    Search single(table);
+    SearchResult first = single.run(board, limits);
+    REQUIRE(first.tableHits > 0);
+    REQUIRE(first.tableMisses > 0);
+    REQUIRE(first.tableHits + first.tableMisses <= 2 * first.nodes);
+
+    // Counts start over with each search; a warm table hits more
+    SearchResult again = single.run(board, limits);
+    REQUIRE(again.tableHits * first.tableMisses > first.tableHits * again.tableMisses);
+
+    // Helpers' probes are added in
+    ParallelSearch parallel(table, 3);
+    table.clear();
+    SearchResult shared = parallel.run(board, limits);
+    REQUIRE(shared.tableHits + shared.tableMisses > 0);
+    REQUIRE(shared.tableHits + shared.tableMisses <= 2 * shared.nodes);
+}
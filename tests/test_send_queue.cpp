@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+#include "networking/send_queue.hpp"
+
+namespace {
+
+SendQueue::Message message(const char* text) {
+    return std::make_shared<const std::string>(text);
+}
+
+} // namespace
+
+TEST_CASE("Send queue keeps one write in flight and gathers the rest") {
+    SendQueue queue;
+
+    REQUIRE(queue.push(message("first\n")));   // idle: start writing
+    REQUIRE(queue.startWrite().size() == 1);
+    REQUIRE(queue.isWriting());
+
+    REQUIRE_FALSE(queue.push(message("second\n"))); // a write is running
+    REQUIRE_FALSE(queue.push(message("third\n")));
+    REQUIRE(queue.queuedMessages() == 2);
+    REQUIRE(queue.queuedBytes() == 13);
+
+    REQUIRE(queue.finishWrite());              // more to send
+    const auto& buffers = queue.startWrite();  // both in one write
+    REQUIRE(buffers.size() == 2);
+    REQUIRE(boost::asio::buffer_size(buffers) == 13);
+    REQUIRE(queue.queuedBytes() == 0);
+
+    REQUIRE_FALSE(queue.finishWrite());
+    REQUIRE_FALSE(queue.isWriting());
+}
+
+TEST_CASE("Send queue keeps shared messages alive until written") {
+    SendQueue a, b;
+    std::weak_ptr<const std::string> watch;
+    {
+        auto shared = message("broadcast\n");
+        watch = shared;
+        a.push(shared);
+        b.push(shared);
+    }
+
+    a.startWrite();
+    a.finishWrite();
+    REQUIRE_FALSE(watch.expired()); // b still holds it
+
+    b.startWrite();
+    b.finishWrite();
+    REQUIRE(watch.expired());
+}
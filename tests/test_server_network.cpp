@@ -0,0 +1,256 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/packed_position.hpp"
+#include "networking/server_network.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+// A fresh directory, removed again at the end of the test
+struct TempDirectory {
+    fs::path path = fs::temp_directory_path() /
+                    ("chessy-server-" + std::to_string(std::random_device{}()));
+    ~TempDirectory() { fs::remove_all(path); }
+};
+
+// A server on a loopback port the system picks, run on a thread of its own.
+// The log goes after the io_context and before the server, as in main().
+struct TestServer {
+    boost::asio::io_context io;
+    TranspositionTable table{ 1 };
+    std::unique_ptr<MoveLog> log;
+    std::unique_ptr<ServerNetwork> server;
+    std::thread thread;
+
+    explicit TestServer(const ConnectionLimits& limits = {},
+                        const std::string& logDirectory = {}) {
+        if (!logDirectory.empty())
+            log = std::make_unique<MoveLog>(logDirectory, 1);
+        server = std::make_unique<ServerNetwork>(io, 0, table, 1, TimeControl{},
+                                                 limits, log.get());
+        server->start();
+        thread = std::thread([this] { io.run(); });
+    }
+
+    ~TestServer() {
+        io.stop();
+        thread.join();
+    }
+
+    unsigned short port() const { return server->port(); }
+};
+
+// A text-protocol client; a read that waits more than two seconds gives up
+class Client {
+public:
+    // `receiveBuffer` bytes of socket buffer, if not the system's default
+    explicit Client(unsigned short port, int receiveBuffer = 0) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{ 2, 0 };
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (receiveBuffer > 0)
+            ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connected_ = ::connect(fd_, reinterpret_cast<sockaddr*>(&address),
+                               sizeof(address)) == 0;
+    }
+
+    ~Client() { ::close(fd_); }
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    bool connected() const { return connected_; }
+
+    void send(std::string_view text) {
+        ::send(fd_, text.data(), text.size(), MSG_NOSIGNAL);
+    }
+
+    // The next line that starts with `prefix`, skipping the others; empty
+    // if the server hangs up or goes quiet first
+    std::string waitFor(std::string_view prefix) {
+        for (;;) {
+            std::size_t end;
+            while ((end = buffer_.find('\n')) != std::string::npos) {
+                std::string line = buffer_.substr(0, end);
+                buffer_.erase(0, end + 1);
+                if (line.compare(0, prefix.size(), prefix) == 0)
+                    return line;
+            }
+            if (!receive())
+                return {};
+        }
+    }
+
+    // Reads past whatever is still coming; true if the server hung up,
+    // false if it went quiet with the connection open
+    bool hungUp() {
+        while (receive())
+            buffer_.clear();
+        return closed_;
+    }
+
+private:
+    bool receive() {
+        char chunk[4096];
+        ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            closed_ = received == 0 || errno == ECONNRESET;
+            return false;
+        }
+        buffer_.append(chunk, static_cast<std::size_t>(received));
+        return true;
+    }
+
+    int fd_ = -1;
+    bool connected_ = false;
+    bool closed_ = false;
+    std::string buffer_;
+};
+
+// "You are White in game 7": the game's ID
+Game::Id gameOf(const std::string& line) {
+    return std::stoull(line.substr(line.rfind(' ') + 1));
+}
+
+// Asks for a game's position until it is `board`'s
+bool waitForPosition(Client& watcher, Game::Id id, const ChessBoard& board) {
+    std::string expected = formatPosition(packPosition(board.snapshot()));
+    expected.pop_back(); // the newline
+    for (int tries = 0; tries < 2000; ++tries) {
+        watcher.send("BOARD " + std::to_string(id) + "\n");
+        if (watcher.waitFor("POSITION ") == expected)
+            return true;
+        std::this_thread::sleep_for(1ms);
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("Moves played before one sync are each announced as played") {
+    TempDirectory dir;
+    TestServer server({}, dir.path.string());
+
+    Client first(server.port()), second(server.port());
+    REQUIRE(first.connected());
+    REQUIRE(second.connected());
+
+    std::string seat = first.waitFor("You are ");
+    REQUIRE(!second.waitFor("You are ").empty());
+
+    // Only once the two are paired, so it cannot take either's place
+    Client watcher(server.port());
+
+    bool firstIsWhite = seat.find("White") != std::string::npos;
+    Client& white = firstIsWhite ? first : second;
+    Client& black = firstIsWhite ? second : first;
+    Game::Id id = gameOf(seat);
+
+    // Hold the log's writer in a callback of its own, so both moves are
+    // still waiting for their sync when the second one is played
+    std::promise<void> held, release;
+    std::shared_future<void> released = release.get_future().share();
+    server.log->logMove(id + 1000, Move(), 0ms, [&held, released] {
+        held.set_value();
+        released.wait();
+    });
+    held.get_future().wait();
+
+    ChessBoard board;
+    board.initialize();
+    white.send("MOVE e2 e4\n");
+    board.playMove(board.fromSAN("e4"));
+    REQUIRE(waitForPosition(watcher, id, board));
+    black.send("MOVE e7 e5\n");
+    board.playMove(board.fromSAN("e5"));
+    REQUIRE(waitForPosition(watcher, id, board));
+
+    // One sync for both; each announcement is its own move
+    release.set_value();
+    std::string firstMove = white.waitFor("MOVED ");
+    std::string secondMove = white.waitFor("MOVED ");
+    REQUIRE(firstMove.rfind("MOVED e2e4 BLACK ONGOING ", 0) == 0);
+    REQUIRE(secondMove.rfind("MOVED e7e5 WHITE ONGOING ", 0) == 0);
+    REQUIRE(black.waitFor("MOVED ") == firstMove);
+    REQUIRE(black.waitFor("MOVED ") == secondMove);
+}
+
+TEST_CASE("A connection that says nothing is dropped after the idle limit") {
+    ConnectionLimits limits;
+    limits.idleTimeout = 1s;
+    TestServer server(limits);
+
+    Client client(server.port());
+    REQUIRE(!client.waitFor("Waiting for an opponent").empty());
+    auto start = std::chrono::steady_clock::now();
+
+    // Not before the limit, and within a tick or so after it
+    REQUIRE(client.hungUp());
+    auto waited = std::chrono::steady_clock::now() - start;
+    REQUIRE(waited > 900ms);
+    REQUIRE(waited < 2s);
+}
+
+TEST_CASE("A connection that does not read is cut off once its backlog passes the limit") {
+    ConnectionLimits limits;
+    limits.maxQueuedBytes = 8 * 1024;
+    TestServer server(limits);
+
+    // A small window, so the server's socket fills and replies queue up
+    Client client(server.port(), 4096);
+    REQUIRE(client.connected());
+
+    // Far more replies than the socket buffers and the limit hold together
+    std::string commands;
+    for (int i = 0; i < 100000; ++i)
+        commands += "BOARD\n";
+    client.send(commands);
+
+    REQUIRE(client.hungUp());
+}
+
+TEST_CASE("Connections beyond the accept rate wait for the bucket to refill") {
+    ConnectionLimits limits;
+    limits.acceptsPerSecond = 2;
+    TestServer server(limits);
+
+    // The listener takes one at once and a second's worth (2) after it;
+    // the rest get in at two a second
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int i = 0; i < 6; ++i)
+        clients.push_back(std::make_unique<Client>(server.port()));
+
+    std::vector<std::chrono::steady_clock::duration> welcomed;
+    for (auto& client : clients) {
+        REQUIRE(!client->waitFor("Welcome!").empty());
+        welcomed.push_back(std::chrono::steady_clock::now() - start);
+    }
+
+    REQUIRE(welcomed[2] < 400ms);
+    REQUIRE(welcomed[3] > 400ms);
+    REQUIRE(welcomed[5] > 1400ms);
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include "game/timing_wheel.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Timers fire on their tick, near or far") {
+    TimingWheel<int> wheel(1000);
+    std::vector<std::uint64_t> deadlines = { 1001, 1063, 1064, 1100, 5000,
+                                             1000 + 64 * 64, 300000, 20000000 };
+    for (std::uint64_t deadline : deadlines)
+        wheel.schedule(deadline, static_cast<int>(deadline - 1000));
+    REQUIRE(wheel.size() == deadlines.size());
+
+    // Step through time in uneven strides, as a late timer would
+    std::vector<std::uint64_t> fired;
+    for (std::uint64_t now = 1000; now < 20000010; now += 7 + now % 5) {
+        wheel.advance(now, [&](int value) {
+            fired.push_back(1000 + value);
+            // Never early, and never more than one stride late
+            REQUIRE(1000 + std::uint64_t(value) <= now);
+            REQUIRE(now - (1000 + std::uint64_t(value)) < 12);
+        });
+    }
+
+    REQUIRE(fired == deadlines);
+    REQUIRE(wheel.size() == 0);
+}
+
+TEST_CASE("Past deadlines fire on the next tick") {
+    TimingWheel<int> wheel(50);
+    wheel.schedule(10, 1);
+    wheel.schedule(50, 2);
+
+    int count = 0;
+    wheel.advance(50, [&](int) { ++count; });
+    REQUIRE(count == 0);
+    wheel.advance(51, [&](int) { ++count; });
+    REQUIRE(count == 2);
+}
+
+TEST_CASE("Timers pushed from many threads all reach the wheel") {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+
+    TimerInbox<std::pair<std::uint64_t, int>> inbox;
+    TimingWheel<int> wheel;
+    std::vector<int> fired;
+
+    // Drain while the pushers are still going, as the tick does
+    std::vector<std::thread> pushers;
+    for (int t = 0; t < kThreads; ++t) {
+        pushers.emplace_back([&inbox, t] {
+            for (int i = 0; i < kPerThread; ++i)
+                inbox.push({ std::uint64_t(1 + i % 100), t * kPerThread + i });
+        });
+    }
+    auto drain = [&] {
+        inbox.drain([&](std::pair<std::uint64_t, int>&& timer) {
+            wheel.schedule(timer.first, timer.second);
+        });
+    };
+    for (int i = 0; i < 100; ++i)
+        drain();
+    for (std::thread& pusher : pushers)
+        pusher.join();
+    drain();
+
+    REQUIRE(wheel.size() == std::size_t(kThreads * kPerThread));
+    wheel.advance(1000, [&](int value) { fired.push_back(value); });
+    std::sort(fired.begin(), fired.end());
+    for (int i = 0; i < kThreads * kPerThread; ++i)
+        REQUIRE(fired[i] == i);
+}
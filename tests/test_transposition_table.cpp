@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+#include "chess/chess_board.hpp"
+#include "engine/transposition_table.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Transposition table store and probe") {
+    TranspositionTable table(1);
+    TTEntry entry;
+
+    std::uint64_t key = 0x123456789ABCDEF0ULL;
+    REQUIRE_FALSE(table.probe(key, entry));
+
+    Move move(makeSquare(4, 6), makeSquare(4, 4), Move::DoublePush);
+    table.store(key, move, -150, 7, Bound::Lower);
+
+    REQUIRE(table.probe(key, entry));
+    REQUIRE(entry.move == move);
+    REQUIRE(entry.score == -150);
+    REQUIRE(entry.depth == 7);
+    REQUIRE(entry.bound == Bound::Lower);
+    REQUIRE_FALSE(entry.statusKnown);
+}
+
+TEST_CASE("Transposition table evicts within a full bucket") {
+    TranspositionTable table(0); // a single bucket
+    REQUIRE(table.entryCount() == 4);
+
+    for (std::uint64_t key = 1; key <= 4; ++key)
+        REQUIRE_FALSE(table.store(key, Move(), 0, static_cast<int>(key), Bound::Exact));
+
+    // The shallowest entry made room for the fifth one
+    REQUIRE(table.store(5, Move(), 0, 5, Bound::Exact));
+    TTEntry entry;
+    REQUIRE_FALSE(table.probe(1, entry));
+    REQUIRE(table.probe(5, entry));
+}
+
+TEST_CASE("Game status is cached by position") {
+    TranspositionTable table(1);
+
+    ChessBoard board;
+    board.initialize();
+    board.movePiece(5, 6, 5, 5); // f2 f3
+    board.movePiece(4, 1, 4, 3); // e7 e5
+    board.movePiece(6, 6, 6, 4); // g2 g4
+    board.movePiece(3, 0, 7, 4); // Qd8 h4#
+
+    REQUIRE(cachedStatus(board, table) == GameStatus::Checkmate);
+
+    TTEntry entry;
+    REQUIRE(table.probe(board.hash(), entry));
+    REQUIRE(entry.statusKnown);
+    REQUIRE(cachedStatus(board, table) == GameStatus::Checkmate);
+}
+
+TEST_CASE("Concurrent writers never produce mismatched entries") {
+    TranspositionTable table(0); // tiny, so every thread fights for the same slots
+    std::atomic<int> mismatches{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&table, &mismatches, t] {
+            for (int i = 0; i < 20000; ++i) {
+                std::uint64_t key = 0x9E3779B97F4A7C15ULL * (i % 64 + 1);
+                // Score is derived from the key, so a torn read would show
+                table.store(key, Move(), static_cast<int>(key % 1000), t, Bound::Exact);
+
+                TTEntry entry;
+                if (table.probe(key, entry) &&
+                    entry.score != static_cast<int>(key % 1000))
+                    ++mismatches;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(mismatches == 0);
+}